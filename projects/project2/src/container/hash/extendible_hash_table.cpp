@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,6 +21,7 @@
 #include "common/logger.h"
 #include "common/rid.h"
 #include "container/hash/extendible_hash_table.h"
+#include "container/hash/extendible_hash_table_iterator.h"
 
 namespace bustub {
 
@@ -55,12 +58,23 @@ HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager
   // Set bucket page id in the directory page
   dir_page->SetBucketPageId(static_cast<uint32_t>(0), bucket_page_id);
   dir_page->SetLocalDepth(0, 0);
-  // The two new pages can be unpinned
+  // The bucket page can be unpinned, the directory page stays pinned
+  // for the lifetime of the hash table (see FetchDirectoryPage)
   assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
-  assert(buffer_pool_manager->UnpinPage(directory_page_id_, true, nullptr));
+  dir_page_ = dir_page;
+  MarkDirectoryDirty();
   table_latch_.WUnlock();
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::~ExtendibleHashTable() {
+  // Release the long-lived pin taken on the directory page
+  if (dir_page_ != nullptr) {
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(directory_page_id_, true, nullptr);
+    assert(unpinned);
+  }
+}
+
 /*****************************************************************************
  * HELPERS
  *****************************************************************************/
@@ -90,13 +104,21 @@ page_id_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HashTableDirectoryPage *HASH_TABLE_TYPE::FetchDirectoryPage() {
-  HashTableDirectoryPage *dir_page = nullptr;
-  // Make a call to the buffer manager to fetch the page into
-  // the buffer pool
-  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  // The directory page is pinned once in the constructor and never unpinned
+  // until the table is destroyed, so it can never be evicted and the lookup
+  // is a plain memory access instead of a buffer pool round trip
+  assert(dir_page_ != nullptr);
+  return dir_page_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MarkDirectoryDirty() {
+  // Pin and immediately unpin the page to set the dirty flag in the buffer pool,
+  // this only happens when the directory is restructured
+  [[maybe_unused]] Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
   assert(page != nullptr);
-  dir_page = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
-  return dir_page;
+  [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(directory_page_id_, true, nullptr);
+  assert(unpinned);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -108,11 +130,56 @@ HASH_TABLE_BUCKET_TYPE *HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_i
   return bucket_page;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_OVERFLOW_TYPE *HASH_TABLE_TYPE::FetchOverflowPage(page_id_t overflow_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(overflow_page_id);
+  assert(page != nullptr);
+  return reinterpret_cast<HASH_TABLE_OVERFLOW_TYPE *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::KeyToOverflowPageId(const KeyType &key, HashTableDirectoryPage *dir_page) {
+  // Most tables have no overflow chain at all, avoid hashing the key again for them
+  if (dir_page->NumOverflowChains() == 0) {
+    return INVALID_PAGE_ID;
+  }
+  return dir_page->GetOverflowPageId(Hash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::vector<std::pair<page_id_t, std::vector<uint32_t>>> HASH_TABLE_TYPE::GroupByBucketPage(
+    const std::vector<KeyType> &keys, HashTableDirectoryPage *dir_page) {
+  // Hash every key once and bucket the key indexes by the target page
+  // std::map keeps the groups ordered by page id, so bucket pages are visited in a stable order
+  std::map<page_id_t, std::vector<uint32_t>> groups;
+  std::vector<uint64_t> hashes(keys.size());
+  hash_fn_.GetHashes(keys.data(), keys.size(), hashes.data());
+  uint32_t global_depth_mask = dir_page->GetGlobalDepthMask();
+  for (uint32_t key_idx = 0; key_idx < keys.size(); key_idx++) {
+    uint32_t bucket_idx = static_cast<uint32_t>(hashes[key_idx]) & global_depth_mask;
+    groups[dir_page->GetBucketPageId(bucket_idx)].push_back(key_idx);
+  }
+  return {groups.begin(), groups.end()};
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::PrefetchBucketPage(HASH_TABLE_BUCKET_TYPE *bucket_page) {
+  // The bitmaps sit at the head of the page and are read before any slot,
+  // so warming the first few cache lines covers the start of every probe
+  constexpr size_t cache_line_size = 64;
+  constexpr size_t prefetch_lines = 4;
+  const char *data = reinterpret_cast<const char *>(bucket_page);
+  for (size_t line = 0; line < prefetch_lines; line++) {
+    __builtin_prefetch(data + line * cache_line_size, 0, 3);
+  }
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
   table_latch_.RLock();
   bool res = false;
   HashTableDirectoryPage *dir_page = FetchDirectoryPage();
@@ -128,19 +195,71 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
   page->RLatch();
   // Get values
   res = bucket_page->GetValue(key, comparator_, result);
-  // Unpin the directory page and the bucket page
-  assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
+  // The values of a duplicate-heavy key continue in its overflow chain
+  page_id_t overflow_page_id = KeyToOverflowPageId(key, dir_page);
+  if (overflow_page_id != INVALID_PAGE_ID) {
+    res = GetOverflowValues(overflow_page_id, key, result) || res;
+  }
+  // Unpin the bucket page, the directory page stays pinned
   assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
   page->RUnlatch();
   table_latch_.RUnlock();
   return res;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MultiGetValue(Transaction *transaction, const std::vector<KeyType> &keys,
+                                    std::vector<std::vector<ValueType>> *result) {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
+  result->clear();
+  result->resize(keys.size());
+  if (keys.empty()) {
+    return false;
+  }
+  table_latch_.RLock();
+  bool res = false;
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  assert(dir_page != nullptr);
+  auto groups = GroupByBucketPage(keys, dir_page);
+  // Read ahead by one bucket: the next bucket page is fetched and prefetched
+  // before the current one is probed, so at most two bucket pages are pinned at a time
+  HASH_TABLE_BUCKET_TYPE *next_bucket_page = FetchBucketPage(groups[0].first);
+  PrefetchBucketPage(next_bucket_page);
+  for (size_t group_idx = 0; group_idx < groups.size(); group_idx++) {
+    page_id_t bucket_page_id = groups[group_idx].first;
+    HASH_TABLE_BUCKET_TYPE *bucket_page = next_bucket_page;
+    if (group_idx + 1 < groups.size()) {
+      next_bucket_page = FetchBucketPage(groups[group_idx + 1].first);
+      PrefetchBucketPage(next_bucket_page);
+    }
+    Page *page = reinterpret_cast<Page *>(bucket_page);
+    assert(page != nullptr);
+    // Probe every key of this bucket under a single latch acquisition
+    page->RLatch();
+    for (uint32_t key_idx : groups[group_idx].second) {
+      if (bucket_page->GetValue(keys[key_idx], comparator_, &(*result)[key_idx])) {
+        res = true;
+      }
+      page_id_t overflow_page_id = KeyToOverflowPageId(keys[key_idx], dir_page);
+      if (overflow_page_id != INVALID_PAGE_ID &&
+          GetOverflowValues(overflow_page_id, keys[key_idx], &(*result)[key_idx])) {
+        res = true;
+      }
+    }
+    page->RUnlatch();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr);
+    assert(unpinned);
+  }
+  table_latch_.RUnlock();
+  return res;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
   table_latch_.RLock();
   bool res = false;
   HashTableDirectoryPage *dir_page = FetchDirectoryPage();
@@ -155,13 +274,22 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
   // If fail to fetch the bucket page, then insertion fails
   assert(page != nullptr);
   page->WLatch();
+  // Once a key hash has an overflow chain, its new values always go to the chain
+  page_id_t overflow_page_id = KeyToOverflowPageId(key, dir_page);
+  if (overflow_page_id != INVALID_PAGE_ID) {
+    res = OverflowInsert(overflow_page_id, bucket_page, key, value);
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr);
+    assert(unpinned);
+    page->WUnlatch();
+    table_latch_.RUnlock();
+    return res;
+  }
   // Insert the KV pair into the bucket
   // First check whether the bucket is full
   if (!bucket_page->IsFull()) {
     // If is not full, insert into the current bucket
     // The insertion will fail if there is a duplicate KV pair
     res = bucket_page->Insert(key, value, comparator_);
-    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
     // After insertion, the bucket page is updated, so it is marked as a dirty page
     assert(buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr));
     page->WUnlatch();
@@ -177,7 +305,6 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
     // the target page for SplitInsert, it makes no sense
     // to always stitch it into the buffer pool
     assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
-    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
     page->WUnlatch();
     table_latch_.RUnlock();
     res = SplitInsert(transaction, key, value);
@@ -201,17 +328,33 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   uint32_t split_bucket_idx = 0;
   page_id_t split_bucket_page_id = 0;
   assert(dir_page != nullptr);
+  // Pay off a bounded part of any lazy directory growth while holding the write latch
+  if (dir_page->MigratePendingSlots(DIRECTORY_MIGRATE_BATCH) > 0) {
+    MarkDirectoryDirty();
+  }
   bucket_idx = KeyToDirectoryIndex(key, dir_page);
   bucket_page_id = KeyToPageId(key, dir_page);
   bucket_page = FetchBucketPage(bucket_page_id);
   Page *buck_page = reinterpret_cast<Page *>(bucket_page);
   assert(buck_page != nullptr);
+  // Another thread may have created an overflow chain for this key hash
+  // before the write latch was acquired
+  page_id_t overflow_page_id = KeyToOverflowPageId(key, dir_page);
+  if (overflow_page_id == INVALID_PAGE_ID && bucket_page->IsFull()) {
+    overflow_page_id = SpillToOverflowChain(dir_page, bucket_page, key);
+  }
+  if (overflow_page_id != INVALID_PAGE_ID) {
+    bool res = OverflowInsert(overflow_page_id, bucket_page, key, value);
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr);
+    assert(unpinned);
+    table_latch_.WUnlock();
+    return res;
+  }
   if (!bucket_page->IsFull()) {
     // If the bucket page becomes not full, apply normal insertion
     // this situation may be due to some intermediate deletions before
     // acquiring the write latch
     bool res = bucket_page->Insert(key, value, comparator_);
-    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
     assert(buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr));
     table_latch_.WUnlock();
     return res;
@@ -228,10 +371,9 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
     // 1. Increment the global depth of the hash table
     // 2. Increment the local depth of the old bucket page
     // Remember to increment the local depth first,
-    // because the call to IncGlobalDepth will copy the content
+    // because the new half of the directory mirrors the old half
     if (dir_page->Size() > (DIRECTORY_ARRAY_SIZE >> 1)) {
       // Insertion fails in this case
-      assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
       assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
       table_latch_.WUnlock();
       return false;
@@ -289,10 +431,10 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   // In either case, the hash table page, the bucket page, and
   // the split bucket page all become dirty pages
   // Unpin after insertion
-  // Unpin the directory page is necessary because we need to set the dirty flag
-  assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), true, nullptr));
+  MarkDirectoryDirty();
   assert(buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr));
   assert(buffer_pool_manager_->UnpinPage(split_bucket_page_id, true, nullptr));
+  num_splits_++;
   // Recursively call Insert after split,
   // the result is false if insertion fails
   // (either hash table error or buffer pool error)
@@ -301,11 +443,265 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   return Insert(transaction, key, value);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MultiInsert(Transaction *transaction, const std::vector<KeyType> &keys,
+                                  const std::vector<ValueType> &values, std::vector<bool> *result) {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
+  assert(keys.size() == values.size());
+  if (result != nullptr) {
+    result->assign(keys.size(), false);
+  }
+  if (keys.empty()) {
+    return true;
+  }
+  bool res = true;
+  // Pairs whose bucket is full cannot be inserted under the read latch,
+  // they are retried one by one through Insert (and SplitInsert) afterwards,
+  // together with pairs that belong to an overflow chain
+  std::vector<uint32_t> deferred;
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  assert(dir_page != nullptr);
+  auto groups = GroupByBucketPage(keys, dir_page);
+  HASH_TABLE_BUCKET_TYPE *next_bucket_page = FetchBucketPage(groups[0].first);
+  PrefetchBucketPage(next_bucket_page);
+  for (size_t group_idx = 0; group_idx < groups.size(); group_idx++) {
+    page_id_t bucket_page_id = groups[group_idx].first;
+    HASH_TABLE_BUCKET_TYPE *bucket_page = next_bucket_page;
+    if (group_idx + 1 < groups.size()) {
+      next_bucket_page = FetchBucketPage(groups[group_idx + 1].first);
+      PrefetchBucketPage(next_bucket_page);
+    }
+    Page *page = reinterpret_cast<Page *>(bucket_page);
+    assert(page != nullptr);
+    bool is_dirty = false;
+    page->WLatch();
+    for (uint32_t key_idx : groups[group_idx].second) {
+      if (bucket_page->IsFull() || KeyToOverflowPageId(keys[key_idx], dir_page) != INVALID_PAGE_ID) {
+        deferred.push_back(key_idx);
+        continue;
+      }
+      bool inserted = bucket_page->Insert(keys[key_idx], values[key_idx], comparator_);
+      is_dirty = is_dirty || inserted;
+      res = res && inserted;
+      if (result != nullptr) {
+        (*result)[key_idx] = inserted;
+      }
+    }
+    page->WUnlatch();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(bucket_page_id, is_dirty, nullptr);
+    assert(unpinned);
+  }
+  table_latch_.RUnlock();
+  // Release all latches before falling back, Insert may need the table write latch
+  for (uint32_t key_idx : deferred) {
+    bool inserted = Insert(transaction, keys[key_idx], values[key_idx]);
+    res = res && inserted;
+    if (result != nullptr) {
+      (*result)[key_idx] = inserted;
+    }
+  }
+  return res;
+}
+
+/*****************************************************************************
+ * OVERFLOW CHAINS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::GetOverflowValues(page_id_t overflow_page_id, const KeyType &key,
+                                        std::vector<ValueType> *result) {
+  bool res = false;
+  while (overflow_page_id != INVALID_PAGE_ID) {
+    HASH_TABLE_OVERFLOW_TYPE *overflow_page = FetchOverflowPage(overflow_page_id);
+    res = overflow_page->GetValue(key, comparator_, result) || res;
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+    assert(unpinned);
+    overflow_page_id = next_page_id;
+  }
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::OverflowInsert(page_id_t overflow_page_id, HASH_TABLE_BUCKET_TYPE *bucket_page,
+                                     const KeyType &key, const ValueType &value) {
+  // Reject duplicate KV pairs, the key may still have older values in the bucket
+  std::vector<ValueType> bucket_values;
+  bucket_page->GetValue(key, comparator_, &bucket_values);
+  if (std::find(bucket_values.begin(), bucket_values.end(), value) != bucket_values.end()) {
+    return false;
+  }
+  // Walk to the tail of the chain, checking for the pair on the way
+  HASH_TABLE_OVERFLOW_TYPE *overflow_page = FetchOverflowPage(overflow_page_id);
+  while (true) {
+    if (overflow_page->Find(key, value, comparator_) != overflow_page->Size()) {
+      [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+      assert(unpinned);
+      return false;
+    }
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+    assert(unpinned);
+    overflow_page_id = next_page_id;
+    overflow_page = FetchOverflowPage(overflow_page_id);
+  }
+  if (overflow_page->IsFull()) {
+    // Extend the chain with a new tail page
+    page_id_t tail_page_id = INVALID_PAGE_ID;
+    Page *page = buffer_pool_manager_->NewPage(&tail_page_id);
+    if (page == nullptr) {
+      [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+      assert(unpinned);
+      return false;
+    }
+    auto tail_page = reinterpret_cast<HASH_TABLE_OVERFLOW_TYPE *>(page->GetData());
+    tail_page->Init();
+    overflow_page->SetNextPageId(tail_page_id);
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, true, nullptr);
+    assert(unpinned);
+    overflow_page_id = tail_page_id;
+    overflow_page = tail_page;
+  }
+  bool res = overflow_page->Append(key, value);
+  [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, true, nullptr);
+  assert(unpinned);
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::OverflowRemove(page_id_t overflow_page_id, const KeyType &key, const ValueType &value,
+                                     bool *chain_is_empty) {
+  *chain_is_empty = false;
+  // First pass: locate the pair, the tail of the chain and the page before the tail
+  page_id_t head_page_id = overflow_page_id;
+  page_id_t hole_page_id = INVALID_PAGE_ID;
+  uint32_t hole_idx = 0;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t tail_page_id = INVALID_PAGE_ID;
+  while (overflow_page_id != INVALID_PAGE_ID) {
+    HASH_TABLE_OVERFLOW_TYPE *overflow_page = FetchOverflowPage(overflow_page_id);
+    if (hole_page_id == INVALID_PAGE_ID) {
+      uint32_t idx = overflow_page->Find(key, value, comparator_);
+      if (idx != overflow_page->Size()) {
+        hole_page_id = overflow_page_id;
+        hole_idx = idx;
+      }
+    }
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+    assert(unpinned);
+    prev_page_id = tail_page_id;
+    tail_page_id = overflow_page_id;
+    overflow_page_id = next_page_id;
+  }
+  if (hole_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  // Second pass: move the last entry of the chain into the hole
+  HASH_TABLE_OVERFLOW_TYPE *tail_page = FetchOverflowPage(tail_page_id);
+  uint32_t last_idx = tail_page->Size() - 1;
+  if (hole_page_id != tail_page_id || hole_idx != last_idx) {
+    HASH_TABLE_OVERFLOW_TYPE *hole_page =
+        hole_page_id == tail_page_id ? tail_page : FetchOverflowPage(hole_page_id);
+    hole_page->SetAt(hole_idx, tail_page->KeyAt(last_idx), tail_page->ValueAt(last_idx));
+    if (hole_page_id != tail_page_id) {
+      [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(hole_page_id, true, nullptr);
+      assert(unpinned);
+    }
+  }
+  tail_page->PopBack();
+  bool tail_is_empty = tail_page->Size() == 0;
+  [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(tail_page_id, true, nullptr);
+  assert(unpinned);
+  // Unlink an emptied tail. An emptied head is left to ReleaseOverflowChain, which
+  // needs the table write latch to unregister the chain
+  *chain_is_empty = tail_is_empty && tail_page_id == head_page_id;
+  if (tail_is_empty && tail_page_id != head_page_id) {
+    HASH_TABLE_OVERFLOW_TYPE *prev_page = FetchOverflowPage(prev_page_id);
+    prev_page->SetNextPageId(INVALID_PAGE_ID);
+    unpinned = buffer_pool_manager_->UnpinPage(prev_page_id, true, nullptr);
+    assert(unpinned);
+    [[maybe_unused]] bool deleted = buffer_pool_manager_->DeletePage(tail_page_id, nullptr);
+    assert(deleted);
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::SpillToOverflowChain(HashTableDirectoryPage *dir_page, HASH_TABLE_BUCKET_TYPE *bucket_page,
+                                                const KeyType &key) {
+  if (dir_page->NumOverflowChains() >= DIRECTORY_OVERFLOW_ARRAY_SIZE) {
+    return INVALID_PAGE_ID;
+  }
+  uint32_t hash = Hash(key);
+  uint32_t num_same_hash = 0;
+  for (uint32_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE; bucket_idx++) {
+    if (bucket_page->IsReadable(bucket_idx) && Hash(bucket_page->KeyAt(bucket_idx)) == hash) {
+      num_same_hash++;
+    }
+  }
+  // Splitting still helps if most of the bucket can be moved to the split image
+  if (num_same_hash * 2 <= BUCKET_ARRAY_SIZE) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t overflow_page_id = INVALID_PAGE_ID;
+  Page *page = buffer_pool_manager_->NewPage(&overflow_page_id);
+  if (page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  auto overflow_page = reinterpret_cast<HASH_TABLE_OVERFLOW_TYPE *>(page->GetData());
+  overflow_page->Init();
+  // Move the entries with this hash out of the bucket, so all values of the key
+  // live in the chain and the bucket has room for other keys again.
+  // An overflow page holds more pairs than a bucket, the head page never fills up here
+  for (uint32_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE; bucket_idx++) {
+    if (bucket_page->IsReadable(bucket_idx) && Hash(bucket_page->KeyAt(bucket_idx)) == hash) {
+      overflow_page->Append(bucket_page->KeyAt(bucket_idx), bucket_page->ValueAt(bucket_idx));
+      bucket_page->RemoveAt(bucket_idx);
+    }
+  }
+  [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, true, nullptr);
+  assert(unpinned);
+  MaybeCompactBucket(bucket_page);
+  dir_page->AddOverflowChain(hash, overflow_page_id);
+  MarkDirectoryDirty();
+  return overflow_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ReleaseOverflowChain(const KeyType &key) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  assert(dir_page != nullptr);
+  uint32_t hash = Hash(key);
+  page_id_t overflow_page_id = dir_page->GetOverflowPageId(hash);
+  // Another thread may have released the chain, or refilled it, since the latches were dropped
+  if (overflow_page_id != INVALID_PAGE_ID) {
+    HASH_TABLE_OVERFLOW_TYPE *overflow_page = FetchOverflowPage(overflow_page_id);
+    // Emptied tails are deleted right away, so an empty head is the whole chain
+    bool is_empty = overflow_page->Size() == 0;
+    assert(!is_empty || overflow_page->GetNextPageId() == INVALID_PAGE_ID);
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(overflow_page_id, false, nullptr);
+    assert(unpinned);
+    if (is_empty) {
+      dir_page->RemoveOverflowChain(hash);
+      MarkDirectoryDirty();
+      [[maybe_unused]] bool deleted = buffer_pool_manager_->DeletePage(overflow_page_id, nullptr);
+      assert(deleted);
+    }
+  }
+  table_latch_.WUnlock();
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
   table_latch_.RLock();
   bool res = false;
   HashTableDirectoryPage *dir_page = FetchDirectoryPage();
@@ -322,14 +718,45 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
   // Delete the KV pair from the hash table
   // Deletion can either succeed or fail
   res = bucket_page->Remove(key, value, comparator_);
+  // Removal leaves a tombstone behind, compact the bucket once they pile up
+  bool chain_is_empty = false;
+  if (res) {
+    MaybeCompactBucket(bucket_page);
+  } else {
+    page_id_t overflow_page_id = KeyToOverflowPageId(key, dir_page);
+    if (overflow_page_id != INVALID_PAGE_ID) {
+      res = OverflowRemove(overflow_page_id, key, value, &chain_is_empty);
+    }
+  }
   assert(buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr));
-  assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
   page->WUnlatch();
   table_latch_.RUnlock();
+  // Free the registry entry and the head page of a chain that has been emptied
+  if (chain_is_empty) {
+    ReleaseOverflowChain(key);
+  }
   Merge(transaction, key, value);
   return res;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MaybeCompactBucket(HASH_TABLE_BUCKET_TYPE *bucket_page) {
+  uint32_t num_tombstones = bucket_page->NumTombstones();
+  uint32_t num_readable = bucket_page->NumReadable();
+  uint32_t num_occupied = num_tombstones + num_readable;
+  if (num_tombstones == 0) {
+    return false;
+  }
+  // An empty bucket is always compacted, that only resets its bitmaps
+  if (num_readable != 0 && (num_occupied < TOMBSTONE_COMPACT_MIN_SLOTS ||
+                            num_tombstones < TOMBSTONE_RATIO_THRESHOLD * static_cast<double>(num_occupied))) {
+    return false;
+  }
+  bucket_page->Compact();
+  num_compactions_++;
+  return true;
+}
+
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
@@ -343,13 +770,16 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
   uint32_t split_bucket_idx = 0;
   page_id_t split_bucket_page_id = 0;
   assert(dir_page != nullptr);
+  // Pay off a bounded part of any lazy directory growth while holding the write latch
+  if (dir_page->MigratePendingSlots(DIRECTORY_MIGRATE_BATCH) > 0) {
+    MarkDirectoryDirty();
+  }
   bucket_idx = KeyToDirectoryIndex(key, dir_page);
   bucket_page_id = KeyToPageId(key, dir_page);
   bucket_page = FetchBucketPage(bucket_page_id);
   if (dir_page->GetLocalDepth(bucket_idx) == 0 || !bucket_page->IsEmpty()) {
     // If the local depth is 0, do not merge
     assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
-    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
     table_latch_.WUnlock();
     return;
   }
@@ -359,7 +789,6 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
   if (dir_page->GetLocalDepth(bucket_idx) != dir_page->GetLocalDepth(split_bucket_idx)) {
     // If local depths are not equal, do not merge
     assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr));
-    assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), false, nullptr));
     table_latch_.WUnlock();
     return;
   }
@@ -389,20 +818,78 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
   while (dir_page->CanShrink()) {
     dir_page->DecrGlobalDepth();
   }
-  // Unpin the directory page
-  assert(buffer_pool_manager_->UnpinPage(dir_page->GetPageId(), true, nullptr));
+  MarkDirectoryDirty();
+  num_merges_++;
   table_latch_.WUnlock();
 }
 
+/*****************************************************************************
+ * ITERATION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_ITERATOR_TYPE HASH_TABLE_TYPE::Begin() {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
+  return HASH_TABLE_ITERATOR_TYPE(this);
+}
+
+/*****************************************************************************
+ * METRICS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+double HASH_TABLE_TYPE::GetTombstoneRatio() {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
+  table_latch_.RLock();
+  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  uint64_t num_tombstones = 0;
+  uint64_t num_occupied = 0;
+  for (uint32_t bucket_idx = 0; bucket_idx < dir_page->Size(); bucket_idx++) {
+    // Several slots may point to the same bucket page, only count it
+    // at the lowest one, which is the slot below 2^local_depth
+    if ((bucket_idx & dir_page->GetLocalDepthMask(bucket_idx)) != bucket_idx) {
+      continue;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
+    Page *page = reinterpret_cast<Page *>(bucket_page);
+    page->RLatch();
+    uint32_t bucket_tombstones = bucket_page->NumTombstones();
+    num_tombstones += bucket_tombstones;
+    num_occupied += bucket_tombstones + bucket_page->NumReadable();
+    page->RUnlatch();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager_->UnpinPage(bucket_page_id, false, nullptr);
+    assert(unpinned);
+  }
+  table_latch_.RUnlock();
+  if (num_occupied == 0) {
+    return 0;
+  }
+  return static_cast<double>(num_tombstones) / static_cast<double>(num_occupied);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint64_t HASH_TABLE_TYPE::GetNumCompactions() const {
+  return num_compactions_.load();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint64_t HASH_TABLE_TYPE::GetNumSplits() const {
+  return num_splits_.load();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint64_t HASH_TABLE_TYPE::GetNumMerges() const {
+  return num_merges_.load();
+}
+
 /*****************************************************************************
  * GETGLOBALDEPTH - DO NOT TOUCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
   table_latch_.RLock();
   HashTableDirectoryPage *dir_page = FetchDirectoryPage();
   uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
   table_latch_.RUnlock();
   return global_depth;
 }
@@ -412,10 +899,10 @@ uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
+  BUSTUB_ASSERT(!IsIteratedByThisThread(), "The table must not be called while this thread iterates it.");
   table_latch_.RLock();
   HashTableDirectoryPage *dir_page = FetchDirectoryPage();
   dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
   table_latch_.RUnlock();
 }
 
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_iterator.cpp
+//
+// Identification: src/container/hash/extendible_hash_table_iterator.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/extendible_hash_table_iterator.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_ITERATOR_TYPE::ExtendibleHashTableIterator(HASH_TABLE_TYPE *table) : table_(table) {
+  table_->table_latch_.RLock();
+#ifndef NDEBUG
+  HASH_TABLE_TYPE::iterated_tables_.push_back(table_);
+#endif
+  dir_page_ = table_->FetchDirectoryPage();
+  // Slot 0 always owns its bucket, prime the read-ahead with it
+  next_bucket_idx_ = 0;
+  next_bucket_page_id_ = dir_page_->GetBucketPageId(0);
+  next_bucket_page_ = table_->FetchBucketPage(next_bucket_page_id_);
+  LoadNextBucket();
+  SeekReadable();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_ITERATOR_TYPE::~ExtendibleHashTableIterator() {
+  BufferPoolManager *buffer_pool_manager = table_->buffer_pool_manager_;
+  if (overflow_page_ != nullptr) {
+    [[maybe_unused]] bool unpinned = buffer_pool_manager->UnpinPage(overflow_page_id_, false, nullptr);
+    assert(unpinned);
+  }
+  if (bucket_page_ != nullptr) {
+    reinterpret_cast<Page *>(bucket_page_)->RUnlatch();
+    [[maybe_unused]] bool unpinned = buffer_pool_manager->UnpinPage(bucket_page_id_, false, nullptr);
+    assert(unpinned);
+  }
+  if (next_bucket_page_ != nullptr) {
+    [[maybe_unused]] bool unpinned = buffer_pool_manager->UnpinPage(next_bucket_page_id_, false, nullptr);
+    assert(unpinned);
+  }
+#ifndef NDEBUG
+  auto &iterated_tables = HASH_TABLE_TYPE::iterated_tables_;
+  iterated_tables.erase(std::find(iterated_tables.begin(), iterated_tables.end(), table_));
+#endif
+  table_->table_latch_.RUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_ITERATOR_TYPE::IsEnd() const {
+  return bucket_page_ == nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType HASH_TABLE_ITERATOR_TYPE::Key() const {
+  assert(!IsEnd());
+  if (overflow_page_ != nullptr) {
+    return overflow_page_->KeyAt(overflow_slot_idx_);
+  }
+  return bucket_page_->KeyAt(slot_idx_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ValueType HASH_TABLE_ITERATOR_TYPE::Value() const {
+  assert(!IsEnd());
+  if (overflow_page_ != nullptr) {
+    return overflow_page_->ValueAt(overflow_slot_idx_);
+  }
+  return bucket_page_->ValueAt(slot_idx_);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+MappingType HASH_TABLE_ITERATOR_TYPE::operator*() const {
+  return MappingType(Key(), Value());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_ITERATOR_TYPE &HASH_TABLE_ITERATOR_TYPE::operator++() {
+  assert(!IsEnd());
+  if (overflow_page_ != nullptr) {
+    overflow_slot_idx_++;
+  } else {
+    slot_idx_++;
+  }
+  SeekReadable();
+  return *this;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_ITERATOR_TYPE::NextBucketIndex(uint32_t from_idx) {
+  // Slots that alias a bucket differ from its lowest slot only above the local depth
+  uint32_t bucket_idx = from_idx;
+  while (bucket_idx < dir_page_->Size() &&
+         (bucket_idx & dir_page_->GetLocalDepthMask(bucket_idx)) != bucket_idx) {
+    bucket_idx++;
+  }
+  return bucket_idx;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_ITERATOR_TYPE::LoadNextBucket() {
+  if (bucket_page_ != nullptr) {
+    reinterpret_cast<Page *>(bucket_page_)->RUnlatch();
+    [[maybe_unused]] bool unpinned = table_->buffer_pool_manager_->UnpinPage(bucket_page_id_, false, nullptr);
+    assert(unpinned);
+  }
+  bucket_idx_ = next_bucket_idx_;
+  bucket_page_id_ = next_bucket_page_id_;
+  bucket_page_ = next_bucket_page_;
+  next_bucket_page_ = nullptr;
+  slot_idx_ = 0;
+  chain_idx_ = 0;
+  if (bucket_page_ == nullptr) {
+    return;
+  }
+  reinterpret_cast<Page *>(bucket_page_)->RLatch();
+  // Read ahead: pin the next bucket and warm its first cache lines while this one is scanned
+  next_bucket_idx_ = NextBucketIndex(bucket_idx_ + 1);
+  if (next_bucket_idx_ < dir_page_->Size()) {
+    next_bucket_page_id_ = dir_page_->GetBucketPageId(next_bucket_idx_);
+    next_bucket_page_ = table_->FetchBucketPage(next_bucket_page_id_);
+    table_->PrefetchBucketPage(next_bucket_page_);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_ITERATOR_TYPE::LoadNextOverflowChain() {
+  uint32_t local_depth_mask = dir_page_->GetLocalDepthMask(bucket_idx_);
+  for (; chain_idx_ < dir_page_->NumOverflowChains(); chain_idx_++) {
+    if ((dir_page_->GetOverflowChainHash(chain_idx_) & local_depth_mask) == bucket_idx_) {
+      overflow_page_id_ = dir_page_->GetOverflowChainPageId(chain_idx_);
+      overflow_page_ = table_->FetchOverflowPage(overflow_page_id_);
+      overflow_slot_idx_ = 0;
+      chain_idx_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_ITERATOR_TYPE::SeekReadable() {
+  while (bucket_page_ != nullptr) {
+    if (overflow_page_ == nullptr) {
+      // Entries of the bucket itself, an unoccupied slot ends the occupied region
+      for (; slot_idx_ < BUCKET_ARRAY_SIZE; slot_idx_++) {
+        if (bucket_page_->IsReadable(slot_idx_)) {
+          return;
+        }
+        if (!bucket_page_->IsOccupied(slot_idx_)) {
+          slot_idx_ = BUCKET_ARRAY_SIZE;
+          break;
+        }
+      }
+      if (!LoadNextOverflowChain()) {
+        LoadNextBucket();
+        continue;
+      }
+    }
+    // Entries of the overflow chain, page by page
+    if (overflow_slot_idx_ < overflow_page_->Size()) {
+      return;
+    }
+    page_id_t next_page_id = overflow_page_->GetNextPageId();
+    [[maybe_unused]] bool unpinned = table_->buffer_pool_manager_->UnpinPage(overflow_page_id_, false, nullptr);
+    assert(unpinned);
+    overflow_page_ = nullptr;
+    if (next_page_id != INVALID_PAGE_ID) {
+      overflow_page_id_ = next_page_id;
+      overflow_page_ = table_->FetchOverflowPage(overflow_page_id_);
+      overflow_slot_idx_ = 0;
+    }
+  }
+}
+
+template class ExtendibleHashTableIterator<int, int, IntComparator>;
+
+template class ExtendibleHashTableIterator<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTableIterator<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTableIterator<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTableIterator<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTableIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
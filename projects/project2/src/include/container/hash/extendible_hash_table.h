@@ -12,24 +12,36 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_overflow_page.h"
 
 namespace bustub {
 
 #define HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTableIterator;
+
 /**
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * Values of keys that are duplicated so heavily that bucket splits cannot
+ * separate them are kept in overflow chains, one chain per key hash. A chain
+ * is protected by the latch of the bucket page its hash maps to.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class ExtendibleHashTable {
@@ -44,6 +56,11 @@ class ExtendibleHashTable {
   explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
 
+  /**
+   * Destroys the ExtendibleHashTable, releasing the pin held on the directory page.
+   */
+  ~ExtendibleHashTable();
+
   /**
    * Inserts a key-value pair into the hash table.
    *
@@ -74,6 +91,69 @@ class ExtendibleHashTable {
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result);
 
+  /**
+   * Performs a batch of point queries on the hash table. The keys are grouped
+   * by bucket page so that the directory is fetched once per batch and every
+   * bucket page is fetched and latched once, no matter how many keys map to it.
+   *
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] result (*result)[i] receives the value(s) associated with keys[i]
+   * @return true if at least one key matched
+   */
+  bool MultiGetValue(Transaction *transaction, const std::vector<KeyType> &keys,
+                     std::vector<std::vector<ValueType>> *result);
+
+  /**
+   * Inserts a batch of key-value pairs into the hash table. Pairs that land in a
+   * bucket with free space are inserted bucket by bucket under one latch
+   * acquisition; pairs whose bucket is full fall back to Insert (and splitting).
+   *
+   * @param transaction the current transaction
+   * @param keys the keys to insert
+   * @param values values[i] is the value to be associated with keys[i]
+   * @param[out] result (*result)[i] is set to whether the i-th pair was inserted, may be nullptr
+   * @return true if every pair was inserted, false otherwise
+   */
+  bool MultiInsert(Transaction *transaction, const std::vector<KeyType> &keys, const std::vector<ValueType> &values,
+                   std::vector<bool> *result);
+
+  /**
+   * Computes the fraction of occupied bucket slots that are tombstones, over
+   * every bucket of the hash table. Lookups have to scan past tombstones, so
+   * this measures how much dead space probes pay for.
+   *
+   * @return tombstones / (tombstones + live entries), 0 if no slot is occupied
+   */
+  double GetTombstoneRatio();
+
+  /**
+   * @return the number of bucket compactions performed so far
+   */
+  uint64_t GetNumCompactions() const;
+
+  /**
+   * @return the number of bucket splits performed so far
+   */
+  uint64_t GetNumSplits() const;
+
+  /**
+   * @return the number of bucket merges performed so far
+   */
+  uint64_t GetNumMerges() const;
+
+  /**
+   * Returns an iterator over all key-value pairs in bucket order. Include
+   * container/hash/extendible_hash_table_iterator.h to use it.
+   *
+   * The iterator holds the table latch in read mode until it is destroyed, so
+   * the thread holding it must not call the table in the meantime, see
+   * ExtendibleHashTableIterator.
+   *
+   * @return an iterator positioned at the first pair
+   */
+  ExtendibleHashTableIterator<KeyType, ValueType, KeyComparator> Begin();
+
   /**
    * Returns the global depth.  Do not touch.
    */
@@ -85,6 +165,21 @@ class ExtendibleHashTable {
   void VerifyIntegrity();
 
  private:
+  friend class ExtendibleHashTableIterator<KeyType, ValueType, KeyComparator>;
+
+#ifndef NDEBUG
+  /**
+   * @return true if the calling thread holds a live iterator over this table,
+   * a table call from that thread could deadlock on table_latch_
+   */
+  bool IsIteratedByThisThread() const {
+    return std::find(iterated_tables_.begin(), iterated_tables_.end(), this) != iterated_tables_.end();
+  }
+
+  /** The tables the calling thread holds live iterators over, one entry per iterator */
+  inline static thread_local std::vector<const ExtendibleHashTable *> iterated_tables_{};
+#endif
+
   /**
    * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
    * for extendible hashing.
@@ -122,12 +217,20 @@ class ExtendibleHashTable {
   page_id_t KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page);
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Returns the directory page. The directory page is pinned in the buffer pool
+   * for the lifetime of the hash table, so this does not touch the buffer pool
+   * manager and callers must not unpin the returned page.
    *
    * @return a pointer to the directory page
    */
   HashTableDirectoryPage *FetchDirectoryPage();
 
+  /**
+   * Marks the directory page as dirty in the buffer pool manager. Must be called
+   * after the directory is modified, with the table write latch held.
+   */
+  void MarkDirectoryDirty();
+
   /**
    * Fetches the bucket page from the buffer pool manager using the bucket's page_id.
    *
@@ -136,6 +239,102 @@ class ExtendibleHashTable {
    */
   HASH_TABLE_BUCKET_TYPE *FetchBucketPage(page_id_t bucket_page_id);
 
+  /**
+   * Groups a batch of keys by the bucket page they map to. Each key is hashed
+   * exactly once. The caller must hold the table latch.
+   *
+   * @param keys the keys to group
+   * @param dir_page a pointer to the hash table's directory page
+   * @return (bucket page_id, indexes into keys) pairs, ordered by page_id
+   */
+  std::vector<std::pair<page_id_t, std::vector<uint32_t>>> GroupByBucketPage(const std::vector<KeyType> &keys,
+                                                                            HashTableDirectoryPage *dir_page);
+
+  /**
+   * Issues software prefetches for the head of a bucket page (the occupied_ and
+   * readable_ bitmaps and the first slots), which every probe touches first.
+   *
+   * @param bucket_page the bucket page to prefetch
+   */
+  void PrefetchBucketPage(HASH_TABLE_BUCKET_TYPE *bucket_page);
+
+  /**
+   * Fetches an overflow page from the buffer pool manager.
+   *
+   * @param overflow_page_id the page_id to fetch
+   * @return a pointer to an overflow page
+   */
+  HASH_TABLE_OVERFLOW_TYPE *FetchOverflowPage(page_id_t overflow_page_id);
+
+  /**
+   * Get the head of the overflow chain of a key, if it has one.
+   *
+   * @param key the key for lookup
+   * @param dir_page a pointer to the hash table's directory page
+   * @return the page_id of the head of the chain, INVALID_PAGE_ID if there is none
+   */
+  page_id_t KeyToOverflowPageId(const KeyType &key, HashTableDirectoryPage *dir_page);
+
+  /**
+   * Collects the values of a key stored in an overflow chain.
+   *
+   * @param overflow_page_id the head of the chain
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with the key are appended to it
+   * @return true if at least one value was found
+   */
+  bool GetOverflowValues(page_id_t overflow_page_id, const KeyType &key, std::vector<ValueType> *result);
+
+  /**
+   * Inserts a key-value pair into the overflow chain of its hash. Fails if the
+   * pair already exists in the bucket page or in the chain. The caller must hold
+   * the write latch of the bucket page.
+   *
+   * @param overflow_page_id the head of the chain
+   * @param bucket_page the bucket page the key maps to
+   * @param key the key to insert
+   * @param value the value to insert
+   * @return true if insert succeeded, false otherwise
+   */
+  bool OverflowInsert(page_id_t overflow_page_id, HASH_TABLE_BUCKET_TYPE *bucket_page, const KeyType &key,
+                      const ValueType &value);
+
+  /**
+   * Removes a key-value pair from an overflow chain. The last entry of the
+   * chain fills the hole, so the chain stays dense, and an emptied tail page
+   * is unlinked and deleted.
+   *
+   * @param overflow_page_id the head of the chain
+   * @param key the key to remove
+   * @param value the value to remove
+   * @param[out] chain_is_empty set to true if the removal emptied the head page, so the chain can be released
+   * @return true if remove succeeded, false if not found
+   */
+  bool OverflowRemove(page_id_t overflow_page_id, const KeyType &key, const ValueType &value, bool *chain_is_empty);
+
+  /**
+   * Moves the entries of a full bucket that share the hash of key into a new
+   * overflow chain, if they make up more than half of the bucket. Splitting
+   * can never separate entries with the same hash, so the split would not make
+   * room for them. Called by SplitInsert with the table write latch held.
+   *
+   * @param dir_page a pointer to the hash table's directory page
+   * @param bucket_page the full bucket page the key maps to
+   * @param key the key about to be inserted
+   * @return the page_id of the head of the new chain, INVALID_PAGE_ID if no chain was created
+   */
+  page_id_t SpillToOverflowChain(HashTableDirectoryPage *dir_page, HASH_TABLE_BUCKET_TYPE *bucket_page,
+                                 const KeyType &key);
+
+  /**
+   * Unregisters the overflow chain of the hash of key and deletes its head
+   * page, if the chain is still empty. Takes the table write latch, since the
+   * chain registry in the directory page is read under the read latch.
+   *
+   * @param key a key whose removal emptied the chain
+   */
+  void ReleaseOverflowChain(const KeyType &key);
+
   /**
    * Performs insertion with an optional bucket splitting.  If the
    * page is still full after the split, then recursively split.
@@ -148,6 +347,16 @@ class ExtendibleHashTable {
    */
   bool SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * Compacts a bucket if its tombstones make up at least TOMBSTONE_RATIO_THRESHOLD
+   * of its occupied slots, or if it has tombstones and no live entry left.
+   * The caller must hold the bucket page's write latch.
+   *
+   * @param bucket_page the bucket page to check
+   * @return true if the bucket was compacted
+   */
+  bool MaybeCompactBucket(HASH_TABLE_BUCKET_TYPE *bucket_page);
+
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
    * if Remove makes a bucket empty.
@@ -165,15 +374,32 @@ class ExtendibleHashTable {
    */
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  // Upper bound on the pending directory slots migrated by a single split or merge
+  static constexpr uint32_t DIRECTORY_MIGRATE_BATCH = 16;
+
+  // Fraction of tombstones among a bucket's occupied slots that triggers a compaction
+  static constexpr double TOMBSTONE_RATIO_THRESHOLD = 0.5;
+  // Buckets with fewer occupied slots than this are never compacted, scanning them is cheap anyway
+  static constexpr uint32_t TOMBSTONE_COMPACT_MIN_SLOTS = 32;
+
   // member variables
   const std::string &name_;
   page_id_t directory_page_id_;
+  // The directory page, pinned from construction until destruction
+  HashTableDirectoryPage *dir_page_{nullptr};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
   // Readers includes inserts and removes, writers are splits and merges
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
+
+  // Number of bucket compactions, updated under bucket latches only
+  std::atomic<uint64_t> num_compactions_{0};
+
+  // Number of bucket splits and merges, updated under the table write latch
+  std::atomic<uint64_t> num_splits_{0};
+  std::atomic<uint64_t> num_merges_{0};
 };
 
 }  // namespace bustub
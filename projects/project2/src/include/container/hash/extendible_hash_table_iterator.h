@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_iterator.h
+//
+// Identification: src/include/container/hash/extendible_hash_table_iterator.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "common/macros.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+#define HASH_TABLE_ITERATOR_TYPE ExtendibleHashTableIterator<KeyType, ValueType, KeyComparator>
+
+/**
+ * Iterator over all (key, value) pairs of an ExtendibleHashTable, in bucket order.
+ *
+ * Every bucket page is visited once: of all directory slots that point to a
+ * bucket, only the lowest one (the slot below 2^local_depth) is followed. The
+ * values of a bucket's overflow chains are visited right after the bucket. The
+ * next bucket page is pinned and prefetched while the current one is scanned.
+ *
+ * Pairs are read straight from the pages, nothing is materialized. To keep that
+ * safe the iterator holds the table latch in read mode for its whole lifetime,
+ * so buckets cannot split or merge under it, and the read latch of the bucket it
+ * is positioned on.
+ *
+ * A thread must not call any method of the table, reads included, while it
+ * holds a live iterator over it: once a writer waits for the table latch, the
+ * second read lock of that thread waits behind the writer, which waits for the
+ * iterator, a deadlock. Debug builds assert this, release builds do not check.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTableIterator {
+ public:
+  /**
+   * Creates an iterator positioned at the first pair of the table.
+   *
+   * @param table the hash table to iterate
+   */
+  explicit ExtendibleHashTableIterator(HASH_TABLE_TYPE *table);
+
+  /**
+   * Releases all latches and pins held by the iterator.
+   */
+  ~ExtendibleHashTableIterator();
+
+  DISALLOW_COPY_AND_MOVE(ExtendibleHashTableIterator);
+
+  /**
+   * @return true if the iterator is past the last pair of the table
+   */
+  bool IsEnd() const;
+
+  /**
+   * @return the key of the current pair
+   */
+  KeyType Key() const;
+
+  /**
+   * @return the value of the current pair
+   */
+  ValueType Value() const;
+
+  /**
+   * @return the current pair
+   */
+  MappingType operator*() const;
+
+  /**
+   * Moves to the next pair.
+   */
+  ExtendibleHashTableIterator &operator++();
+
+ private:
+  /**
+   * @param from_idx the directory slot to start searching from
+   * @return the lowest directory slot at or after from_idx that owns its bucket,
+   * the directory size if there is none
+   */
+  uint32_t NextBucketIndex(uint32_t from_idx);
+
+  /**
+   * Releases the current bucket and moves to the read-ahead bucket, then reads
+   * ahead the bucket after it.
+   */
+  void LoadNextBucket();
+
+  /**
+   * Fetches the head of the next overflow chain whose keys hash to the current bucket.
+   *
+   * @return false if the bucket has no more overflow chains
+   */
+  bool LoadNextOverflowChain();
+
+  /**
+   * Moves forward from the current position to the first readable pair,
+   * crossing into overflow chains and following buckets as needed.
+   */
+  void SeekReadable();
+
+  HASH_TABLE_TYPE *table_;
+  HashTableDirectoryPage *dir_page_;
+
+  // The bucket currently scanned, read latched
+  uint32_t bucket_idx_{0};
+  page_id_t bucket_page_id_{INVALID_PAGE_ID};
+  HASH_TABLE_BUCKET_TYPE *bucket_page_{nullptr};
+  uint32_t slot_idx_{0};
+
+  // The bucket after it, pinned only
+  uint32_t next_bucket_idx_{0};
+  page_id_t next_bucket_page_id_{INVALID_PAGE_ID};
+  HASH_TABLE_BUCKET_TYPE *next_bucket_page_{nullptr};
+
+  // The overflow chain page currently scanned, protected by the bucket latch
+  uint32_t chain_idx_{0};
+  page_id_t overflow_page_id_{INVALID_PAGE_ID};
+  HASH_TABLE_OVERFLOW_TYPE *overflow_page_{nullptr};
+  uint32_t overflow_slot_idx_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,286 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function.h
+//
+// Identification: src/include/container/hash/hash_function.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The crc32 instruction is used through a target attribute and picked at runtime,
+// so the build does not have to target SSE4.2
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define BUSTUB_HAS_CRC32C_INSTRUCTION 1
+#endif
+
+#include "murmur3/MurmurHash3.h"
+
+namespace bustub {
+
+/**
+ * Hash algorithms a HashFunction can be configured with.
+ *
+ * MURMUR3 is the original BusTub hash. CRC32C uses the SSE4.2 crc32
+ * instruction when the CPU supports it and a table driven fallback otherwise,
+ * it is the fastest choice for integer and other short fixed-width keys.
+ * XXH3 is a multiply-fold hash in the style of XXH3 that handles keys of any
+ * length, including variable-length data.
+ */
+enum class HashAlgorithm { MURMUR3, CRC32C, XXH3 };
+
+namespace hash_internal {
+
+/** Reflected CRC32C (Castagnoli) polynomial. */
+static constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+
+constexpr std::array<uint32_t, 256> MakeCrc32cTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t byte = 0; byte < 256; byte++) {
+    uint32_t crc = byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) != 0 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+    }
+    table[byte] = crc;
+  }
+  return table;
+}
+
+inline constexpr std::array<uint32_t, 256> CRC32C_TABLE = MakeCrc32cTable();
+
+inline uint64_t Read64(const char *data) {
+  uint64_t val;
+  memcpy(&val, data, sizeof(val));
+  return val;
+}
+
+inline uint32_t Read32(const char *data) {
+  uint32_t val;
+  memcpy(&val, data, sizeof(val));
+  return val;
+}
+
+/** CRC32C of a byte range, a table lookup per byte. */
+inline uint32_t Crc32cSoftware(uint32_t crc, const char *data, size_t len) {
+  while (len > 0) {
+    crc = (crc >> 8) ^ CRC32C_TABLE[(crc ^ static_cast<uint8_t>(*data)) & 0xFF];
+    data++;
+    len--;
+  }
+  return crc;
+}
+
+#ifdef BUSTUB_HAS_CRC32C_INSTRUCTION
+/** CRC32C of a byte range with the SSE4.2 crc32 instruction, eight bytes at a time. */
+__attribute__((target("sse4.2"))) inline uint32_t Crc32cHardware(uint32_t crc, const char *data, size_t len) {
+  while (len >= 8) {
+    crc = static_cast<uint32_t>(_mm_crc32_u64(crc, Read64(data)));
+    data += 8;
+    len -= 8;
+  }
+  if (len >= 4) {
+    crc = _mm_crc32_u32(crc, Read32(data));
+    data += 4;
+    len -= 4;
+  }
+  while (len > 0) {
+    crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+    data++;
+    len--;
+  }
+  return crc;
+}
+
+/** @return true if the CPU has the SSE4.2 crc32 instruction, checked once per process */
+inline bool HasCrc32cInstruction() {
+  static const bool has_instruction = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+  }();
+  return has_instruction;
+}
+#endif
+
+/** The Murmur3 64-bit finalizer, every input bit affects every output bit. */
+inline uint64_t FMix64(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/** 64x64->128 bit multiply, folded back to 64 bits. */
+inline uint64_t MulFold64(uint64_t lhs, uint64_t rhs) {
+  __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+
+inline uint64_t Avalanche(uint64_t hash) {
+  hash ^= hash >> 37;
+  hash *= 0x165667919E3779F9ULL;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+/** Per-lane keys mixed into the input, the role the secret plays in XXH3. */
+static constexpr std::array<uint64_t, 8> XXH3_SECRET = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL, 0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL};
+
+}  // namespace hash_internal
+
+/**
+ * CRC32C over a byte range. The CRC only has 32 bits, they are spread over the
+ * 64-bit result with the Murmur3 finalizer so that any subset of the result bits,
+ * like the low bits extendible hashing masks, depends on the whole key.
+ */
+inline uint64_t Crc32cHash(const char *data, size_t len) {
+#ifdef BUSTUB_HAS_CRC32C_INSTRUCTION
+  uint32_t crc = hash_internal::HasCrc32cInstruction() ? hash_internal::Crc32cHardware(0, data, len)
+                                                       : hash_internal::Crc32cSoftware(0, data, len);
+#else
+  uint32_t crc = hash_internal::Crc32cSoftware(0, data, len);
+#endif
+  return hash_internal::FMix64(crc);
+}
+
+/**
+ * XXH3-style hash over a byte range: short inputs are read as at most two words,
+ * longer inputs are consumed 16 bytes at a time with a multiply-fold per chunk.
+ * This is not bit compatible with the reference XXH3.
+ */
+inline uint64_t Xxh3Hash(const char *data, size_t len) {
+  using hash_internal::MulFold64;
+  using hash_internal::Read32;
+  using hash_internal::Read64;
+  using hash_internal::XXH3_SECRET;
+  if (len <= 16) {
+    if (len > 8) {
+      uint64_t lo = Read64(data) ^ XXH3_SECRET[0];
+      uint64_t hi = Read64(data + len - 8) ^ XXH3_SECRET[1];
+      return hash_internal::Avalanche(len + MulFold64(lo, hi));
+    }
+    if (len >= 4) {
+      uint64_t combined = Read32(data) + (static_cast<uint64_t>(Read32(data + len - 4)) << 32);
+      return hash_internal::Avalanche(MulFold64(combined ^ XXH3_SECRET[2], hash_internal::PRIME64_1 + len));
+    }
+    uint64_t combined = 0;
+    if (len > 0) {
+      // Pack the first, middle and last byte together with the length
+      combined = (static_cast<uint64_t>(static_cast<uint8_t>(data[0])) << 16) |
+                 (static_cast<uint64_t>(static_cast<uint8_t>(data[len >> 1])) << 24) |
+                 static_cast<uint8_t>(data[len - 1]) | (len << 8);
+    }
+    return hash_internal::Avalanche((combined ^ XXH3_SECRET[3]) * hash_internal::PRIME64_2);
+  }
+  uint64_t acc = len * hash_internal::PRIME64_1;
+  size_t lane = 0;
+  const char *end = data + len;
+  while (end - data > 16) {
+    acc += MulFold64(Read64(data) ^ XXH3_SECRET[lane], Read64(data + 8) ^ XXH3_SECRET[lane + 1]);
+    lane = (lane + 2) % XXH3_SECRET.size();
+    data += 16;
+  }
+  // The last 16 bytes may overlap the previous chunk, which keeps the tail branch free
+  acc += MulFold64(Read64(end - 16) ^ XXH3_SECRET[6], Read64(end - 8) ^ hash_internal::PRIME64_3);
+  return hash_internal::Avalanche(acc);
+}
+
+/**
+ * Murmur3 over a byte range, the original BusTub hash.
+ */
+inline uint64_t Murmur3Hash(const char *data, size_t len) {
+  uint64_t hash[2];
+  murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(data), static_cast<int>(len), 0,
+                               reinterpret_cast<void *>(&hash));
+  return hash[0];
+}
+
+/**
+ * Hashes a byte range with the given algorithm.
+ */
+inline uint64_t HashBytes(HashAlgorithm algorithm, const char *data, size_t len) {
+  switch (algorithm) {
+    case HashAlgorithm::CRC32C:
+      return Crc32cHash(data, len);
+    case HashAlgorithm::XXH3:
+      return Xxh3Hash(data, len);
+    case HashAlgorithm::MURMUR3:
+    default:
+      return Murmur3Hash(data, len);
+  }
+}
+
+template <typename KeyType>
+class HashFunction {
+ public:
+  /**
+   * @param algorithm the hash algorithm used for every key
+   */
+  explicit HashFunction(HashAlgorithm algorithm = HashAlgorithm::MURMUR3) : algorithm_(algorithm) {}
+
+  virtual ~HashFunction() = default;
+
+  /**
+   * @param key the key to be hashed
+   * @return the hashed value
+   */
+  virtual uint64_t GetHash(KeyType key) {
+    return HashBytes(algorithm_, reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  }
+
+  /**
+   * Hashes a batch of keys. The algorithm is dispatched once for the whole batch,
+   * so the per-key loop is a straight run of the selected hash. Subclasses that
+   * override GetHash must override GetHashes as well.
+   *
+   * @param keys the keys to be hashed
+   * @param num_keys the number of keys
+   * @param[out] hashes the hashed values, one per key
+   */
+  virtual void GetHashes(const KeyType *keys, size_t num_keys, uint64_t *hashes) {
+    switch (algorithm_) {
+      case HashAlgorithm::CRC32C:
+        HashBatch<Crc32cHash>(keys, num_keys, hashes);
+        break;
+      case HashAlgorithm::XXH3:
+        HashBatch<Xxh3Hash>(keys, num_keys, hashes);
+        break;
+      case HashAlgorithm::MURMUR3:
+      default:
+        HashBatch<Murmur3Hash>(keys, num_keys, hashes);
+        break;
+    }
+  }
+
+  /** @return the hash algorithm of this hash function */
+  HashAlgorithm GetAlgorithm() const { return algorithm_; }
+
+ private:
+  template <uint64_t (*Hasher)(const char *, size_t)>
+  static void HashBatch(const KeyType *keys, size_t num_keys, uint64_t *hashes) {
+    for (size_t key_idx = 0; key_idx < num_keys; key_idx++) {
+      hashes[key_idx] = Hasher(reinterpret_cast<const char *>(&keys[key_idx]), sizeof(KeyType));
+    }
+  }
+
+  HashAlgorithm algorithm_;
+};
+
+}  // namespace bustub
@@ -12,14 +12,59 @@
 
 #pragma once
 
+#include <cstring>
 #include <utility>
 #include <vector>
 
 #include "common/config.h"
+#include "storage/index/generic_key.h"
 #include "storage/index/int_comparator.h"
 #include "storage/page/hash_table_page_defs.h"
 
 namespace bustub {
+
+/**
+ * Chooses the slot layout of a bucket page at compile time.
+ *
+ * By default keys and values are interleaved as std::pair. Fixed-width keys
+ * (integers and GenericKey<N>) use the split layout instead: all keys are
+ * stored contiguously, followed by all values, so a probe only streams
+ * through keys and more of them share a cache line.
+ */
+template <typename KeyType, typename ValueType>
+struct BucketLayoutTraits {
+  static constexpr bool SPLIT_LAYOUT = false;
+};
+
+template <typename ValueType>
+struct BucketLayoutTraits<int, ValueType> {
+  static constexpr bool SPLIT_LAYOUT = true;
+};
+
+template <size_t KeySize, typename ValueType>
+struct BucketLayoutTraits<GenericKey<KeySize>, ValueType> {
+  static constexpr bool SPLIT_LAYOUT = true;
+};
+
+/**
+ * Key equality used when probing a bucket page. Defaults to the comparator;
+ * int keys are compared inline instead of through the functor. GenericKey<N>
+ * keeps its comparator: whether its bytes can be compared directly depends on
+ * the key schema (a DECIMAL column compares 0.0 equal to -0.0), which is only
+ * known at runtime.
+ */
+template <typename KeyType, typename KeyComparator>
+struct BucketKeyEqual {
+  static inline bool Equals(const KeyType &lhs, const KeyType &rhs, const KeyComparator &cmp) {
+    return cmp(lhs, rhs) == 0;
+  }
+};
+
+template <>
+struct BucketKeyEqual<int, IntComparator> {
+  static inline bool Equals(int lhs, int rhs, const IntComparator &cmp) { return lhs == rhs; }
+};
+
 /**
  * Store indexed key and and value together within bucket page. Supports
  * non-unique keys.
@@ -33,6 +78,12 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ * Split bucket page format, used when BucketLayoutTraits<KeyType, ValueType>::SPLIT_LAYOUT:
+ *  ----------------------------------------------------------------
+ * | KEY(1) | KEY(2) | ... | KEY(n) | VALUE(1) | VALUE(2) | ... | VALUE(n)
+ *  ----------------------------------------------------------------
+ *
+ *  Both formats hold the same number of slots (BUCKET_ARRAY_SIZE).
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -123,6 +174,18 @@ class HashTableBucketPage {
    */
   uint32_t NumReadable();
 
+  /**
+   * @return the number of tombstones, i.e. slots that are occupied but no longer readable
+   */
+  uint32_t NumTombstones();
+
+  /**
+   * Rewrites the readable entries contiguously at the front of the bucket and
+   * resets occupied_ to cover exactly those entries, so scans stop right after
+   * the last live entry again. Entries may move to a different index.
+   */
+  void Compact();
+
   /**
    * @return whether the bucket is full
    */
@@ -139,6 +202,33 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /** Whether keys and values are stored in separate contiguous regions */
+  static constexpr bool SPLIT_LAYOUT = BucketLayoutTraits<KeyType, ValueType>::SPLIT_LAYOUT;
+  /** Byte offset of the value region from array_ in the split layout */
+  static constexpr size_t VALUES_OFFSET = BUCKET_ARRAY_SIZE * sizeof(KeyType);
+
+  static_assert(!SPLIT_LAYOUT || VALUES_OFFSET % alignof(ValueType) == 0, "Misaligned value region");
+  static_assert(!SPLIT_LAYOUT || sizeof(KeyType) + sizeof(ValueType) <= sizeof(MappingType),
+                "Split layout must fit in the space of the interleaved layout");
+
+  /** @return the address of the key stored at bucket_idx */
+  KeyType *KeySlot(uint32_t bucket_idx);
+  const KeyType *KeySlot(uint32_t bucket_idx) const;
+
+  /** @return the address of the value stored at bucket_idx */
+  ValueType *ValueSlot(uint32_t bucket_idx);
+  const ValueType *ValueSlot(uint32_t bucket_idx) const;
+
+  /**
+   * Writes a key and value into bucket_idx without touching the bitmaps.
+   */
+  void WriteAt(uint32_t bucket_idx, const KeyType &key, const ValueType &value);
+
+  /**
+   * @return true if the key stored at bucket_idx equals key
+   */
+  bool KeyEqualsAt(const KeyType &key, uint32_t bucket_idx, const KeyComparator &cmp) const;
+
   // For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
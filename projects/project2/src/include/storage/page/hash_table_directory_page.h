@@ -22,14 +22,30 @@
 
 namespace bustub {
 
+// Maximum number of overflow chains a hash table can have at once
+#define DIRECTORY_OVERFLOW_ARRAY_SIZE 128
+
 /**
  *
  * Directory Page for extendible hash table.
  *
  * Directory format (size in byte):
- * --------------------------------------------------------------------------------------------
- * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
- * --------------------------------------------------------------------------------------------
+ * ------------------------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Pending(64) |
+ * ------------------------------------------------------------------------------------------------------------
+ * | NumOverflowChains(4) | OverflowHashes(512) | OverflowPageIds(512) | Free(432)
+ * ------------------------------------------------------------------------------------------------------------
+ *
+ * The directory grows lazily. Doubling the directory does not copy the lower
+ * half into the upper half; the new slots are only marked as pending. A
+ * pending slot mirrors its alias, the slot with its highest bit cleared, and
+ * is materialized (copied from the alias) the first time it, or the alias, is
+ * written. Remaining pending slots are migrated a few at a time by
+ * MigratePendingSlots, so growth cost is spread over later restructurings.
+ *
+ * The overflow table maps a full 32-bit key hash to the head page of the
+ * overflow chain that holds values of keys with that hash. A chain is
+ * unregistered again once its values have all been removed.
  */
 class HashTableDirectoryPage {
  public:
@@ -171,6 +187,61 @@ class HashTableDirectoryPage {
    */
   uint32_t GetLocalHighBit(uint32_t bucket_idx);
 
+  /**
+   * Materializes up to max_slots pending directory slots, in index order.
+   *
+   * @param max_slots the maximum number of slots to migrate
+   * @return the number of slots that were migrated
+   */
+  uint32_t MigratePendingSlots(uint32_t max_slots);
+
+  /**
+   * @return the number of directory slots that are still pending
+   */
+  uint32_t NumPendingSlots();
+
+  /**
+   * Looks up the overflow chain of a key hash.
+   *
+   * @param hash the full (unmasked) hash of a key
+   * @return the page id of the head of the chain, INVALID_PAGE_ID if there is none
+   */
+  page_id_t GetOverflowPageId(uint32_t hash);
+
+  /**
+   * Registers the head page of a new overflow chain.
+   *
+   * @param hash the full (unmasked) hash of the keys stored in the chain
+   * @param overflow_page_id the page id of the head of the chain
+   * @return false if the overflow table is full
+   */
+  bool AddOverflowChain(uint32_t hash, page_id_t overflow_page_id);
+
+  /**
+   * Unregisters the overflow chain of a key hash. The last chain takes its
+   * place, so chain indexes are not stable across removals.
+   *
+   * @param hash the full (unmasked) hash of the keys stored in the chain
+   */
+  void RemoveOverflowChain(uint32_t hash);
+
+  /**
+   * @return the number of overflow chains
+   */
+  uint32_t NumOverflowChains();
+
+  /**
+   * @param chain_idx the index of an overflow chain, below NumOverflowChains()
+   * @return the full hash of the keys stored in the chain
+   */
+  uint32_t GetOverflowChainHash(uint32_t chain_idx);
+
+  /**
+   * @param chain_idx the index of an overflow chain, below NumOverflowChains()
+   * @return the page id of the head of the chain
+   */
+  page_id_t GetOverflowChainPageId(uint32_t chain_idx);
+
   /**
    * VerifyIntegrity
    *
@@ -187,11 +258,51 @@ class HashTableDirectoryPage {
   void PrintDirectory();
 
  private:
+  /**
+   * @return true if the slot at bucket_idx has not been materialized yet
+   */
+  bool IsPending(uint32_t bucket_idx) const;
+
+  /**
+   * Marks every slot in [begin_idx, end_idx) as pending.
+   */
+  void SetPending(uint32_t begin_idx, uint32_t end_idx);
+
+  /**
+   * Maps a directory index to the slot that physically holds its entry,
+   * by clearing the highest bit of the index as long as the slot is pending.
+   *
+   * @param bucket_idx the directory index
+   * @return the index of the materialized slot that bucket_idx mirrors
+   */
+  uint32_t ResolveIndex(uint32_t bucket_idx) const;
+
+  /**
+   * Copies the entry a pending slot mirrors into the slot itself.
+   *
+   * @param bucket_idx the slot to materialize, a no-op if it is not pending
+   */
+  void MaterializeSlot(uint32_t bucket_idx);
+
+  /**
+   * Must be called before the slot at bucket_idx is modified. Materializes the
+   * slot itself and every pending slot that directly mirrors it, so those keep
+   * their current entry.
+   *
+   * @param bucket_idx the slot that is about to be written
+   */
+  void PrepareWrite(uint32_t bucket_idx);
+
   page_id_t page_id_;
   lsn_t lsn_;
   uint32_t global_depth_{0};
   uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
   page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+  // 1 if the slot is pending (mirrors its alias), 0 once materialized
+  char pending_[DIRECTORY_ARRAY_SIZE / 8];
+  uint32_t num_overflow_chains_;
+  uint32_t overflow_hashes_[DIRECTORY_OVERFLOW_ARRAY_SIZE];
+  page_id_t overflow_page_ids_[DIRECTORY_OVERFLOW_ARRAY_SIZE];
 };
 
 }  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_overflow_page.h
+//
+// Identification: src/include/storage/page/hash_table_overflow_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define HASH_TABLE_OVERFLOW_TYPE HashTableOverflowPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * Overflow page of the extendible hash table. Overflow pages form a singly
+ * linked chain that holds the values of keys that are too heavily duplicated
+ * to be separated by bucket splits. All keys in one chain share the same hash.
+ *
+ * Entries are kept dense: they occupy [0, size_) and removal moves another
+ * entry into the hole, so no bitmaps are needed and scans are sequential.
+ *
+ * Overflow page format (size in byte):
+ *  ----------------------------------------------------------------------------
+ * | NextPageId (4) | Size (4) | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableOverflowPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableOverflowPage() = delete;
+
+  /**
+   * Initializes a freshly allocated overflow page as an empty chain tail.
+   */
+  void Init();
+
+  /**
+   * @return the page id of the next page in the chain, INVALID_PAGE_ID for the tail
+   */
+  page_id_t GetNextPageId() const;
+
+  /**
+   * @param next_page_id the page id of the next page in the chain
+   */
+  void SetNextPageId(page_id_t next_page_id);
+
+  /**
+   * @return the number of entries in this page
+   */
+  uint32_t Size() const;
+
+  /**
+   * @return whether the page has no free slot left
+   */
+  bool IsFull() const;
+
+  /**
+   * Scan the page and collect values that have the matching key
+   *
+   * @return true if at least one key matched
+   */
+  bool GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const;
+
+  /**
+   * Finds a key and value.
+   *
+   * @return the index of the matching entry, or Size() if not found
+   */
+  uint32_t Find(KeyType key, ValueType value, KeyComparator cmp) const;
+
+  /**
+   * Appends a key and value. Does not check for duplicates.
+   *
+   * @return true if appended, false if the page is full
+   */
+  bool Append(KeyType key, ValueType value);
+
+  /**
+   * Gets the key at an index in the page.
+   */
+  KeyType KeyAt(uint32_t idx) const;
+
+  /**
+   * Gets the value at an index in the page.
+   */
+  ValueType ValueAt(uint32_t idx) const;
+
+  /**
+   * Overwrites the entry at an index in the page.
+   */
+  void SetAt(uint32_t idx, KeyType key, ValueType value);
+
+  /**
+   * Removes the last entry of the page.
+   */
+  void PopBack();
+
+ private:
+  /** Number of entries that fit in one overflow page */
+  static constexpr size_t OVERFLOW_ARRAY_SIZE =
+      (PAGE_SIZE - sizeof(page_id_t) - sizeof(uint32_t)) / sizeof(MappingType);
+
+  page_id_t next_page_id_;
+  uint32_t size_;
+  // Do not add any members below array_, as they will overlap.
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -24,7 +24,7 @@ bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vecto
   bool res = false;
   // Iterate through the region for KV pairs, check equality for the key
   for (size_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE; bucket_idx++) {
-    if (IsReadable(bucket_idx) && cmp(key, KeyAt(bucket_idx)) == 0) {
+    if (IsReadable(bucket_idx) && KeyEqualsAt(key, bucket_idx, cmp)) {
       result->push_back(ValueAt(bucket_idx));
       res = true;
     } else if (!IsOccupied(bucket_idx)) {
@@ -44,7 +44,7 @@ bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator
   // Check duplicate, insertion in one pass
   for (size_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE; bucket_idx++) {
     if (IsReadable(bucket_idx)) {
-      if (cmp(key, KeyAt(bucket_idx)) == 0 && value == ValueAt(bucket_idx)) {
+      if (KeyEqualsAt(key, bucket_idx, cmp) && value == *ValueSlot(bucket_idx)) {
         return false;
       }
     } else if (insert_idx == BUCKET_ARRAY_SIZE) {
@@ -64,7 +64,7 @@ bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator
     // we can insert a new KV pari in this case
     return false;
   }
-  array_[insert_idx] = std::make_pair(key, value);
+  WriteAt(insert_idx, key, value);
   SetReadable(insert_idx);
   SetOccupied(insert_idx);
   return true;
@@ -82,7 +82,7 @@ bool HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator
     if (!IsReadable(bucket_idx)) {
       continue;
     }
-    if (cmp(key, KeyAt(bucket_idx)) == 0 && value == ValueAt(bucket_idx)) {
+    if (KeyEqualsAt(key, bucket_idx, cmp) && value == *ValueSlot(bucket_idx)) {
       // The entries to be deleted is found
       // Reset the readable_ bitmap
       RemoveAt(bucket_idx);
@@ -95,7 +95,7 @@ bool HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const {
   if (IsReadable(bucket_idx)) {
-    return array_[bucket_idx].first;
+    return *KeySlot(bucket_idx);
   }
   return {};
 }
@@ -103,11 +103,58 @@ KeyType HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const {
   if (IsReadable(bucket_idx)) {
-    return array_[bucket_idx].second;
+    return *ValueSlot(bucket_idx);
   }
   return {};
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType *HASH_TABLE_BUCKET_TYPE::KeySlot(uint32_t bucket_idx) {
+  if constexpr (SPLIT_LAYOUT) {
+    return reinterpret_cast<KeyType *>(reinterpret_cast<char *>(array_)) + bucket_idx;
+  } else {
+    return &array_[bucket_idx].first;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const KeyType *HASH_TABLE_BUCKET_TYPE::KeySlot(uint32_t bucket_idx) const {
+  if constexpr (SPLIT_LAYOUT) {
+    return reinterpret_cast<const KeyType *>(reinterpret_cast<const char *>(array_)) + bucket_idx;
+  } else {
+    return &array_[bucket_idx].first;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ValueType *HASH_TABLE_BUCKET_TYPE::ValueSlot(uint32_t bucket_idx) {
+  if constexpr (SPLIT_LAYOUT) {
+    return reinterpret_cast<ValueType *>(reinterpret_cast<char *>(array_) + VALUES_OFFSET) + bucket_idx;
+  } else {
+    return &array_[bucket_idx].second;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const ValueType *HASH_TABLE_BUCKET_TYPE::ValueSlot(uint32_t bucket_idx) const {
+  if constexpr (SPLIT_LAYOUT) {
+    return reinterpret_cast<const ValueType *>(reinterpret_cast<const char *>(array_) + VALUES_OFFSET) + bucket_idx;
+  } else {
+    return &array_[bucket_idx].second;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::WriteAt(uint32_t bucket_idx, const KeyType &key, const ValueType &value) {
+  *KeySlot(bucket_idx) = key;
+  *ValueSlot(bucket_idx) = value;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::KeyEqualsAt(const KeyType &key, uint32_t bucket_idx, const KeyComparator &cmp) const {
+  return BucketKeyEqual<KeyType, KeyComparator>::Equals(key, *KeySlot(bucket_idx), cmp);
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
   if (!IsReadable(bucket_idx)) {
@@ -187,6 +234,45 @@ uint32_t HASH_TABLE_BUCKET_TYPE::NumReadable() {
   return count;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BUCKET_TYPE::NumTombstones() {
+  // A readable slot is always occupied, so the tombstones are the
+  // occupied bits minus the readable bits, counted a byte at a time
+  uint32_t num_occupied = 0;
+  uint32_t num_readable = 0;
+  for (size_t arr_idx = 0; arr_idx < sizeof(occupied_); arr_idx++) {
+    num_occupied += __builtin_popcount(static_cast<uint8_t>(occupied_[arr_idx]));
+    num_readable += __builtin_popcount(static_cast<uint8_t>(readable_[arr_idx]));
+  }
+  return num_occupied - num_readable;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::Compact() {
+  // Slide every readable entry down to the first free position,
+  // relative order of the entries is preserved
+  uint32_t write_idx = 0;
+  for (uint32_t read_idx = 0; read_idx < BUCKET_ARRAY_SIZE; read_idx++) {
+    if (!IsOccupied(read_idx)) {
+      break;
+    }
+    if (!IsReadable(read_idx)) {
+      continue;
+    }
+    if (write_idx != read_idx) {
+      WriteAt(write_idx, *KeySlot(read_idx), *ValueSlot(read_idx));
+    }
+    write_idx++;
+  }
+  // Only the compacted prefix is occupied and readable afterwards
+  std::memset(occupied_, 0, sizeof(occupied_));
+  std::memset(readable_, 0, sizeof(readable_));
+  for (uint32_t bucket_idx = 0; bucket_idx < write_idx; bucket_idx++) {
+    SetOccupied(bucket_idx);
+    SetReadable(bucket_idx);
+  }
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::IsEmpty() {
   for (size_t bucket_idx = 0; bucket_idx < BUCKET_ARRAY_SIZE; bucket_idx++) {
@@ -30,14 +30,12 @@ uint32_t HashTableDirectoryPage::GetGlobalDepth() { return global_depth_; }
 uint32_t HashTableDirectoryPage::GetGlobalDepthMask() { return (static_cast<uint32_t>(1) << global_depth_) - 1; }
 
 void HashTableDirectoryPage::IncrGlobalDepth() {
-  // Perform the resize operation, double the directory size and
-  // populate the local variables
+  // Perform the resize operation, double the directory size
   // Make sure that the global depth does not exceed the maximum
   assert(Size() <= (DIRECTORY_ARRAY_SIZE >> 1));
-  // Populate the local_depths_ array
-  std::memcpy(local_depths_ + Size(), local_depths_, Size() * sizeof(uint8_t));
-  // Populate the bucket_page_ids_ array
-  std::memcpy(bucket_page_ids_ + Size(), bucket_page_ids_, Size() * sizeof(page_id_t));
+  // The upper half is not populated here, its slots are marked as pending
+  // and mirror the lower half until they are materialized
+  SetPending(Size(), Size() << 1);
   global_depth_++;
 }
 
@@ -46,9 +44,12 @@ void HashTableDirectoryPage::DecrGlobalDepth() {
   global_depth_--;
 }
 
-page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) { return bucket_page_ids_[bucket_idx]; }
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) {
+  return bucket_page_ids_[ResolveIndex(bucket_idx)];
+}
 
 void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  PrepareWrite(bucket_idx);
   bucket_page_ids_[bucket_idx] = bucket_page_id;
 }
 
@@ -62,7 +63,7 @@ uint32_t HashTableDirectoryPage::Size() { return static_cast<uint32_t>(1) << glo
 
 bool HashTableDirectoryPage::CanShrink() {
   for (uint32_t curr_idx = 0; curr_idx < Size(); curr_idx++) {
-    if (static_cast<uint32_t>(local_depths_[curr_idx]) >= global_depth_) {
+    if (GetLocalDepth(curr_idx) >= global_depth_) {
       return false;
     }
   }
@@ -70,7 +71,7 @@ bool HashTableDirectoryPage::CanShrink() {
 }
 
 uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) {
-  return static_cast<uint32_t>(local_depths_[bucket_idx]);
+  return static_cast<uint32_t>(local_depths_[ResolveIndex(bucket_idx)]);
 }
 
 uint32_t HashTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) {
@@ -79,16 +80,19 @@ uint32_t HashTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) {
 
 void HashTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
   assert(local_depth <= global_depth_);
+  PrepareWrite(bucket_idx);
   local_depths_[bucket_idx] = local_depth;
 }
 
 void HashTableDirectoryPage::IncrLocalDepth(uint32_t bucket_idx) {
+  PrepareWrite(bucket_idx);
   assert(local_depths_[bucket_idx] < global_depth_);
   local_depths_[bucket_idx]++;
 }
 
 void HashTableDirectoryPage::DecrLocalDepth(uint32_t bucket_idx) {
   // Local depth decrease happens after merging
+  PrepareWrite(bucket_idx);
   assert(local_depths_[bucket_idx] > 0);
   local_depths_[bucket_idx]--;
 }
@@ -97,7 +101,122 @@ uint32_t HashTableDirectoryPage::GetLocalHighBit(uint32_t bucket_idx) {
   // Set the (local depth)'s bit to 1 and return the result
   // E.g. if the local depth is 3,
   // return 0b00...0100
-  return (static_cast<uint32_t>(1) << local_depths_[bucket_idx]) >> 1;
+  return (static_cast<uint32_t>(1) << GetLocalDepth(bucket_idx)) >> 1;
+}
+
+uint32_t HashTableDirectoryPage::MigratePendingSlots(uint32_t max_slots) {
+  uint32_t migrated = 0;
+  for (uint32_t curr_idx = 0; curr_idx < Size() && migrated < max_slots; curr_idx++) {
+    if (pending_[curr_idx / 8] == 0) {
+      // Skip a whole byte of materialized slots at once
+      curr_idx |= 7;
+      continue;
+    }
+    if (IsPending(curr_idx)) {
+      MaterializeSlot(curr_idx);
+      migrated++;
+    }
+  }
+  return migrated;
+}
+
+uint32_t HashTableDirectoryPage::NumPendingSlots() {
+  uint32_t count = 0;
+  for (uint32_t curr_idx = 0; curr_idx < Size(); curr_idx++) {
+    if (IsPending(curr_idx)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+page_id_t HashTableDirectoryPage::GetOverflowPageId(uint32_t hash) {
+  for (uint32_t chain_idx = 0; chain_idx < num_overflow_chains_; chain_idx++) {
+    if (overflow_hashes_[chain_idx] == hash) {
+      return overflow_page_ids_[chain_idx];
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+bool HashTableDirectoryPage::AddOverflowChain(uint32_t hash, page_id_t overflow_page_id) {
+  assert(GetOverflowPageId(hash) == INVALID_PAGE_ID);
+  if (num_overflow_chains_ >= DIRECTORY_OVERFLOW_ARRAY_SIZE) {
+    return false;
+  }
+  overflow_hashes_[num_overflow_chains_] = hash;
+  overflow_page_ids_[num_overflow_chains_] = overflow_page_id;
+  num_overflow_chains_++;
+  return true;
+}
+
+void HashTableDirectoryPage::RemoveOverflowChain(uint32_t hash) {
+  for (uint32_t chain_idx = 0; chain_idx < num_overflow_chains_; chain_idx++) {
+    if (overflow_hashes_[chain_idx] == hash) {
+      num_overflow_chains_--;
+      overflow_hashes_[chain_idx] = overflow_hashes_[num_overflow_chains_];
+      overflow_page_ids_[chain_idx] = overflow_page_ids_[num_overflow_chains_];
+      return;
+    }
+  }
+  assert(false);
+}
+
+uint32_t HashTableDirectoryPage::NumOverflowChains() { return num_overflow_chains_; }
+
+uint32_t HashTableDirectoryPage::GetOverflowChainHash(uint32_t chain_idx) {
+  assert(chain_idx < num_overflow_chains_);
+  return overflow_hashes_[chain_idx];
+}
+
+page_id_t HashTableDirectoryPage::GetOverflowChainPageId(uint32_t chain_idx) {
+  assert(chain_idx < num_overflow_chains_);
+  return overflow_page_ids_[chain_idx];
+}
+
+bool HashTableDirectoryPage::IsPending(uint32_t bucket_idx) const {
+  return (pending_[bucket_idx / 8] & (static_cast<char>(1) << (bucket_idx % 8))) != 0;
+}
+
+void HashTableDirectoryPage::SetPending(uint32_t begin_idx, uint32_t end_idx) {
+  uint32_t curr_idx = begin_idx;
+  // Set single bits up to a byte boundary, then whole bytes
+  for (; curr_idx < end_idx && curr_idx % 8 != 0; curr_idx++) {
+    pending_[curr_idx / 8] |= (static_cast<char>(1) << (curr_idx % 8));
+  }
+  if (curr_idx < end_idx) {
+    std::memset(pending_ + curr_idx / 8, 0xff, (end_idx - curr_idx) / 8);
+  }
+}
+
+uint32_t HashTableDirectoryPage::ResolveIndex(uint32_t bucket_idx) const {
+  // Slot 0 is never pending, so this terminates after at most global_depth_ steps
+  while (bucket_idx != 0 && IsPending(bucket_idx)) {
+    // Clear the highest set bit, i.e. move to the slot this one was doubled from
+    bucket_idx ^= static_cast<uint32_t>(1) << (31 - __builtin_clz(bucket_idx));
+  }
+  return bucket_idx;
+}
+
+void HashTableDirectoryPage::MaterializeSlot(uint32_t bucket_idx) {
+  if (!IsPending(bucket_idx)) {
+    return;
+  }
+  uint32_t source_idx = ResolveIndex(bucket_idx);
+  local_depths_[bucket_idx] = local_depths_[source_idx];
+  bucket_page_ids_[bucket_idx] = bucket_page_ids_[source_idx];
+  pending_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
+
+void HashTableDirectoryPage::PrepareWrite(uint32_t bucket_idx) {
+  MaterializeSlot(bucket_idx);
+  // The slots that directly mirror bucket_idx are bucket_idx with one higher bit set.
+  // Any longer chain of pending slots resolving to bucket_idx passes through one of them,
+  // so materializing these keeps every mirror of the old entry intact
+  uint32_t high_bit = bucket_idx == 0 ? 1 : static_cast<uint32_t>(1) << (32 - __builtin_clz(bucket_idx));
+  for (; (bucket_idx | high_bit) < Size(); high_bit <<= 1) {
+    MaterializeSlot(bucket_idx | high_bit);
+  }
 }
 
 /**
@@ -117,8 +236,8 @@ void HashTableDirectoryPage::VerifyIntegrity() {
 
   //  verify for each bucket_page_id, pointer
   for (uint32_t curr_idx = 0; curr_idx < Size(); curr_idx++) {
-    page_id_t curr_page_id = bucket_page_ids_[curr_idx];
-    uint32_t curr_ld = local_depths_[curr_idx];
+    page_id_t curr_page_id = GetBucketPageId(curr_idx);
+    uint32_t curr_ld = GetLocalDepth(curr_idx);
     assert(curr_ld <= global_depth_);
 
     ++page_id_to_count[curr_page_id];
@@ -156,7 +275,7 @@ void HashTableDirectoryPage::PrintDirectory() {
   LOG_DEBUG("======== DIRECTORY (global_depth_: %u) ========", global_depth_);
   LOG_DEBUG("| bucket_idx | page_id | local_depth |");
   for (uint32_t idx = 0; idx < static_cast<uint32_t>(0x1 << global_depth_); idx++) {
-    LOG_DEBUG("|      %u     |     %u     |     %u     |", idx, bucket_page_ids_[idx], local_depths_[idx]);
+    LOG_DEBUG("|      %u     |     %u     |     %u     |", idx, GetBucketPageId(idx), GetLocalDepth(idx));
   }
   LOG_DEBUG("================ END DIRECTORY ================");
 }
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_overflow_page.cpp
+//
+// Identification: src/storage/page/hash_table_overflow_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+
+#include "storage/page/hash_table_overflow_page.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_OVERFLOW_TYPE::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_OVERFLOW_TYPE::GetNextPageId() const {
+  return next_page_id_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_OVERFLOW_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_OVERFLOW_TYPE::Size() const {
+  return size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_OVERFLOW_TYPE::IsFull() const {
+  return size_ >= OVERFLOW_ARRAY_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_OVERFLOW_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const {
+  bool res = false;
+  for (uint32_t idx = 0; idx < size_; idx++) {
+    if (cmp(key, array_[idx].first) == 0) {
+      result->push_back(array_[idx].second);
+      res = true;
+    }
+  }
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_OVERFLOW_TYPE::Find(KeyType key, ValueType value, KeyComparator cmp) const {
+  for (uint32_t idx = 0; idx < size_; idx++) {
+    if (cmp(key, array_[idx].first) == 0 && value == array_[idx].second) {
+      return idx;
+    }
+  }
+  return size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_OVERFLOW_TYPE::Append(KeyType key, ValueType value) {
+  if (IsFull()) {
+    return false;
+  }
+  array_[size_] = std::make_pair(key, value);
+  size_++;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType HASH_TABLE_OVERFLOW_TYPE::KeyAt(uint32_t idx) const {
+  return array_[idx].first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ValueType HASH_TABLE_OVERFLOW_TYPE::ValueAt(uint32_t idx) const {
+  return array_[idx].second;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_OVERFLOW_TYPE::SetAt(uint32_t idx, KeyType key, ValueType value) {
+  array_[idx] = std::make_pair(key, value);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_OVERFLOW_TYPE::PopBack() {
+  assert(size_ > 0);
+  size_--;
+}
+
+template class HashTableOverflowPage<int, int, IntComparator>;
+
+template class HashTableOverflowPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableOverflowPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableOverflowPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableOverflowPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableOverflowPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,466 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_index_bench.cpp
+//
+// Identification: tools/hash_index_bench/hash_index_bench.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+#include "type/type_id.h"
+
+/**
+ * Benchmark and stress harness for ExtendibleHashTable.
+ *
+ * Runs a configurable mix of GetValue, Insert and Remove from several threads
+ * over a ParallelBufferPoolManager, then reports throughput, latency
+ * percentiles, and how often the table split and merged buckets. The global
+ * depth is sampled while the workload runs to show when restructuring happens.
+ *
+ * Example:
+ *   hash_index_bench --threads=8 --key_size=16 --dist=zipf --theta=0.99 --pool_size=64
+ */
+
+namespace bustub {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+  size_t threads = 4;
+  uint64_t duration_ms = 5000;
+  uint64_t sample_ms = 250;
+  // Operation mix in percent, the rest of the operations are lookups
+  uint32_t insert_pct = 25;
+  uint32_t remove_pct = 25;
+  uint64_t key_space = 100000;
+  // Fraction of the key space inserted before the timed run starts, scaled down if the table cannot hold it
+  double preload = 0.5;
+  std::string dist = "uniform";
+  double theta = 0.99;
+  size_t key_size = 8;
+  HashAlgorithm hash = HashAlgorithm::MURMUR3;
+  size_t num_instances = 4;
+  size_t pool_size = 256;
+  std::string db_file = "hash_index_bench.db";
+  uint64_t seed = 15445;
+  // Latencies kept per thread for the percentiles, a uniform sample of all operations once exceeded
+  size_t latency_samples = 1 << 20;
+};
+
+/** Zipfian generator over [0, n), following Gray et al., "Quickly Generating Billion-Record Synthetic Databases". */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta) : n_(n), theta_(theta) {
+    zetan_ = Zeta(n, theta);
+    double zeta2 = Zeta(2, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetan_);
+  }
+
+  uint64_t Next(std::mt19937_64 *rng) const {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(*rng);
+    double uz = u * zetan_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, theta_)) {
+      return 1;
+    }
+    auto rank = static_cast<uint64_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    return std::min(rank, n_ - 1);
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  uint64_t n_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+};
+
+/** Picks keys from the key space according to the configured distribution. */
+class KeyChooser {
+ public:
+  KeyChooser(const BenchConfig &config, const ZipfianGenerator *zipf, uint64_t seed)
+      : key_space_(config.key_space), zipf_(zipf), rng_(seed) {}
+
+  uint64_t Next() {
+    if (zipf_ == nullptr) {
+      return std::uniform_int_distribution<uint64_t>(0, key_space_ - 1)(rng_);
+    }
+    // Scatter the hot ranks over the key space instead of clustering them at the low keys
+    return (zipf_->Next(&rng_) * 0x9E3779B97F4A7C15ULL) % key_space_;
+  }
+
+  uint32_t NextPercent() { return std::uniform_int_distribution<uint32_t>(0, 99)(rng_); }
+
+ private:
+  uint64_t key_space_;
+  const ZipfianGenerator *zipf_;
+  std::mt19937_64 rng_;
+};
+
+inline void MakeKey(uint64_t k, int *key) { *key = static_cast<int>(k); }
+
+template <size_t KeySize>
+inline void MakeKey(uint64_t k, GenericKey<KeySize> *key) {
+  key->SetFromInteger(static_cast<int64_t>(k));
+}
+
+inline void MakeValue(uint64_t k, int *value) { *value = static_cast<int>(k); }
+
+inline void MakeValue(uint64_t k, RID *value) {
+  *value = RID(static_cast<page_id_t>(k >> 32), static_cast<uint32_t>(k));
+}
+
+/** Keeps a uniform sample of at most a fixed number of latencies, using Vitter's algorithm R, and the maximum. */
+class LatencyReservoir {
+ public:
+  LatencyReservoir(size_t capacity, uint64_t seed) : capacity_(capacity), rng_(seed) { samples_.reserve(capacity); }
+
+  void Add(uint32_t latency_ns) {
+    num_seen_++;
+    max_ = std::max(max_, latency_ns);
+    if (samples_.size() < capacity_) {
+      samples_.push_back(latency_ns);
+      return;
+    }
+    uint64_t idx = std::uniform_int_distribution<uint64_t>(0, num_seen_ - 1)(rng_);
+    if (idx < capacity_) {
+      samples_[idx] = latency_ns;
+    }
+  }
+
+  const std::vector<uint32_t> &GetSamples() const { return samples_; }
+
+  uint32_t GetMax() const { return max_; }
+
+ private:
+  size_t capacity_;
+  uint64_t num_seen_{0};
+  uint32_t max_{0};
+  std::mt19937_64 rng_;
+  std::vector<uint32_t> samples_;
+};
+
+/** Per thread results, padded so that the progress counters do not share a cache line. */
+struct alignas(64) WorkerStats {
+  std::atomic<uint64_t> ops{0};
+  uint64_t reads = 0;
+  uint64_t read_hits = 0;
+  uint64_t inserts = 0;
+  uint64_t insert_successes = 0;
+  uint64_t removes = 0;
+  uint64_t remove_successes = 0;
+  std::unique_ptr<LatencyReservoir> latencies_ns;
+};
+
+struct DepthSample {
+  uint64_t elapsed_ms;
+  uint64_t ops;
+  uint32_t global_depth;
+  uint64_t splits;
+  uint64_t merges;
+};
+
+double Percentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[idx] / 1000.0;
+}
+
+/** @return false if the initial data does not fit into the table */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool RunBench(const BenchConfig &config, BufferPoolManager *bpm, const KeyComparator &comparator) {
+  ExtendibleHashTable<KeyType, ValueType, KeyComparator> table("bench", bpm, comparator,
+                                                               HashFunction<KeyType>(config.hash));
+
+  // Load the initial data. Every directory slot pointing to its own full bucket is the most the table can hold,
+  // hashing never fills the buckets that evenly, so wide keys are preloaded up to half of that
+  auto preload_keys = static_cast<uint64_t>(config.preload * static_cast<double>(config.key_space));
+  uint64_t capacity = static_cast<uint64_t>(DIRECTORY_ARRAY_SIZE) * BUCKET_ARRAY_SIZE;
+  if (preload_keys > capacity / 2) {
+    printf("the table holds at most %lu pairs of this size, preloading %lu keys instead of %lu\n", capacity,
+           capacity / 2, preload_keys);
+    preload_keys = capacity / 2;
+  }
+  KeyType key;
+  ValueType value;
+  uint64_t loaded_keys = 0;
+  for (uint64_t k = 0; k < preload_keys; k++) {
+    MakeKey(k, &key);
+    MakeValue(k, &value);
+    if (!table.Insert(nullptr, key, value)) {
+      fprintf(stderr, "preload stopped after %lu of %lu keys, the table is full\n", loaded_keys, preload_keys);
+      return false;
+    }
+    loaded_keys++;
+  }
+  uint64_t preload_splits = table.GetNumSplits();
+  printf("preloaded %lu keys, global depth %u, %lu splits\n", loaded_keys, table.GetGlobalDepth(), preload_splits);
+
+  std::unique_ptr<ZipfianGenerator> zipf;
+  if (config.dist == "zipf") {
+    zipf = std::make_unique<ZipfianGenerator>(config.key_space, config.theta);
+  }
+
+  std::vector<WorkerStats> stats(config.threads);
+  for (size_t tid = 0; tid < config.threads; tid++) {
+    stats[tid].latencies_ns = std::make_unique<LatencyReservoir>(config.latency_samples, ~(config.seed + tid));
+  }
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> workers;
+  for (size_t tid = 0; tid < config.threads; tid++) {
+    workers.emplace_back([&, tid] {
+      WorkerStats &s = stats[tid];
+      KeyChooser chooser(config, zipf.get(), config.seed + tid);
+      KeyType k;
+      ValueType v;
+      std::vector<ValueType> result;
+      while (!stop.load(std::memory_order_relaxed)) {
+        uint64_t key_num = chooser.Next();
+        uint32_t op = chooser.NextPercent();
+        MakeKey(key_num, &k);
+        MakeValue(key_num, &v);
+        auto start = Clock::now();
+        if (op < config.insert_pct) {
+          s.inserts++;
+          s.insert_successes += table.Insert(nullptr, k, v) ? 1 : 0;
+        } else if (op < config.insert_pct + config.remove_pct) {
+          s.removes++;
+          s.remove_successes += table.Remove(nullptr, k, v) ? 1 : 0;
+        } else {
+          s.reads++;
+          result.clear();
+          s.read_hits += table.GetValue(nullptr, k, &result) ? 1 : 0;
+        }
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        s.latencies_ns->Add(static_cast<uint32_t>(std::min<int64_t>(latency, UINT32_MAX)));
+        s.ops.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  // Sample the table shape while the workers run
+  std::vector<DepthSample> samples;
+  auto begin = Clock::now();
+  auto deadline = begin + std::chrono::milliseconds(config.duration_ms);
+  while (Clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(config.sample_ms));
+    uint64_t ops = 0;
+    for (auto &s : stats) {
+      ops += s.ops.load(std::memory_order_relaxed);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count();
+    samples.push_back({static_cast<uint64_t>(elapsed), ops, table.GetGlobalDepth(),
+                       table.GetNumSplits() - preload_splits, table.GetNumMerges()});
+  }
+  stop = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  // Aggregate the results
+  WorkerStats total;
+  std::vector<uint32_t> latencies_ns;
+  uint32_t max_latency_ns = 0;
+  for (auto &s : stats) {
+    total.reads += s.reads;
+    total.read_hits += s.read_hits;
+    total.inserts += s.inserts;
+    total.insert_successes += s.insert_successes;
+    total.removes += s.removes;
+    total.remove_successes += s.remove_successes;
+    latencies_ns.insert(latencies_ns.end(), s.latencies_ns->GetSamples().begin(), s.latencies_ns->GetSamples().end());
+    max_latency_ns = std::max(max_latency_ns, s.latencies_ns->GetMax());
+  }
+  std::sort(latencies_ns.begin(), latencies_ns.end());
+  uint64_t num_ops = total.reads + total.inserts + total.removes;
+
+  printf("\n%-10s %8s %8s %10s %8s\n", "time_ms", "kops/s", "depth", "splits", "merges");
+  uint64_t prev_ms = 0;
+  uint64_t prev_ops = 0;
+  for (const auto &sample : samples) {
+    double interval = static_cast<double>(std::max<uint64_t>(sample.elapsed_ms - prev_ms, 1));
+    printf("%-10lu %8.1f %8u %10lu %8lu\n", sample.elapsed_ms, static_cast<double>(sample.ops - prev_ops) / interval,
+           sample.global_depth, sample.splits, sample.merges);
+    prev_ms = sample.elapsed_ms;
+    prev_ops = sample.ops;
+  }
+
+  printf("\nthroughput: %.0f ops/s (%lu ops in %.2f s)\n", static_cast<double>(num_ops) / seconds, num_ops, seconds);
+  printf("reads:      %lu (%lu hits)\n", total.reads, total.read_hits);
+  printf("inserts:    %lu (%lu succeeded)\n", total.inserts, total.insert_successes);
+  printf("removes:    %lu (%lu succeeded)\n", total.removes, total.remove_successes);
+  printf("latency us: p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n", Percentile(latencies_ns, 0.5),
+         Percentile(latencies_ns, 0.9), Percentile(latencies_ns, 0.99), Percentile(latencies_ns, 0.999),
+         max_latency_ns / 1000.0);
+  printf("restructuring: %lu splits, %lu merges, %lu compactions, final global depth %u\n",
+         table.GetNumSplits() - preload_splits, table.GetNumMerges(), table.GetNumCompactions(),
+         table.GetGlobalDepth());
+  table.VerifyIntegrity();
+  return true;
+}
+
+void Usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [--threads=N] [--duration_ms=N] [--sample_ms=N] [--insert_pct=N] [--remove_pct=N]\n"
+          "          [--key_space=N] [--preload=F] [--dist=uniform|zipf] [--theta=F] [--key_size=4|8|16|32|64]\n"
+          "          [--hash=murmur3|crc32c|xxh3] [--instances=N] [--pool_size=N] [--db_file=PATH] [--seed=N]\n"
+          "          [--latency_samples=N]\n",
+          prog);
+}
+
+bool ParseArgs(int argc, char **argv, BenchConfig *config) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+      return false;
+    }
+    std::string name = arg.substr(2, eq - 2);
+    std::string val = arg.substr(eq + 1);
+    if (name == "threads") {
+      config->threads = std::stoul(val);
+    } else if (name == "duration_ms") {
+      config->duration_ms = std::stoull(val);
+    } else if (name == "sample_ms") {
+      config->sample_ms = std::stoull(val);
+    } else if (name == "insert_pct") {
+      config->insert_pct = std::stoul(val);
+    } else if (name == "remove_pct") {
+      config->remove_pct = std::stoul(val);
+    } else if (name == "key_space") {
+      config->key_space = std::stoull(val);
+    } else if (name == "preload") {
+      config->preload = std::stod(val);
+    } else if (name == "dist") {
+      config->dist = val;
+    } else if (name == "theta") {
+      config->theta = std::stod(val);
+    } else if (name == "key_size") {
+      config->key_size = std::stoul(val);
+    } else if (name == "hash") {
+      if (val == "murmur3") {
+        config->hash = HashAlgorithm::MURMUR3;
+      } else if (val == "crc32c") {
+        config->hash = HashAlgorithm::CRC32C;
+      } else if (val == "xxh3") {
+        config->hash = HashAlgorithm::XXH3;
+      } else {
+        return false;
+      }
+    } else if (name == "instances") {
+      config->num_instances = std::stoul(val);
+    } else if (name == "pool_size") {
+      config->pool_size = std::stoul(val);
+    } else if (name == "db_file") {
+      config->db_file = val;
+    } else if (name == "seed") {
+      config->seed = std::stoull(val);
+    } else if (name == "latency_samples") {
+      config->latency_samples = std::stoul(val);
+    } else {
+      return false;
+    }
+  }
+  return config->threads > 0 && config->key_space > 1 && config->sample_ms > 0 && config->latency_samples > 0 &&
+         config->insert_pct + config->remove_pct <= 100 && (config->dist == "uniform" || config->dist == "zipf") &&
+         (config->dist == "uniform" || (config->theta > 0 && config->theta < 1));
+}
+
+}  // namespace
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  using bustub::BenchConfig;
+  using bustub::GenericComparator;
+  using bustub::GenericKey;
+  using bustub::RID;
+  using bustub::RunBench;
+
+  BenchConfig config;
+  if (!bustub::ParseArgs(argc, argv, &config)) {
+    bustub::Usage(argv[0]);
+    return 1;
+  }
+  printf("threads=%zu duration_ms=%lu mix=%u/%u/%u (get/insert/remove) key_space=%lu dist=%s", config.threads,
+         config.duration_ms, 100 - config.insert_pct - config.remove_pct, config.insert_pct, config.remove_pct,
+         config.key_space, config.dist.c_str());
+  if (config.dist == "zipf") {
+    printf(" theta=%.2f", config.theta);
+  }
+  const char *hash_names[] = {"murmur3", "crc32c", "xxh3"};
+  printf(" key_size=%zu hash=%s pool=%zux%zu frames\n", config.key_size, hash_names[static_cast<int>(config.hash)],
+         config.num_instances, config.pool_size);
+
+  // Generic keys hold a single BIGINT, wider keys are zero padded
+  bustub::Schema key_schema({bustub::Column("key", bustub::TypeId::BIGINT)});
+  auto *disk_manager = new bustub::DiskManager(config.db_file);
+  auto *bpm = new bustub::ParallelBufferPoolManager(config.num_instances, config.pool_size, disk_manager);
+  bool ok = false;
+  switch (config.key_size) {
+    case 4:
+      ok = RunBench<int, int, bustub::IntComparator>(config, bpm, bustub::IntComparator());
+      break;
+    case 8:
+      ok = RunBench<GenericKey<8>, RID, GenericComparator<8>>(config, bpm, GenericComparator<8>(&key_schema));
+      break;
+    case 16:
+      ok = RunBench<GenericKey<16>, RID, GenericComparator<16>>(config, bpm, GenericComparator<16>(&key_schema));
+      break;
+    case 32:
+      ok = RunBench<GenericKey<32>, RID, GenericComparator<32>>(config, bpm, GenericComparator<32>(&key_schema));
+      break;
+    case 64:
+      ok = RunBench<GenericKey<64>, RID, GenericComparator<64>>(config, bpm, GenericComparator<64>(&key_schema));
+      break;
+    default:
+      bustub::Usage(argv[0]);
+  }
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(config.db_file.c_str());
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager)
+    : pool_size_(pool_size), num_instances_(num_instances), start_idx_(0) {
+  // Allocate and create individual BufferPoolManagerInstances
+  // Preallocate enough space for parallel BPMs
+  bpm_list_.resize(num_instances);
+  for (uint32_t i = 0; i < num_instances; i++) {
+    bpm_list_[i] = new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager);
+  }
+}
+
+// Update constructor to destruct all BufferPoolManagerInstances and deallocate any associated memory
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (uint32_t i = 0; i < num_instances_; i++) {
+    delete bpm_list_[i];
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  // Get size of all BufferPoolManagerInstances
+  return num_instances_ * pool_size_;
+}
+
+BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+  // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
+  return bpm_list_[page_id % num_instances_];
+}
+
+Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
+  // Fetch page for page_id from responsible BufferPoolManagerInstance
+  BufferPoolManager *bpm = this->GetBufferPoolManager(page_id);
+  return bpm->FetchPage(page_id);
+}
+
+bool ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) {
+  // Unpin page_id from responsible BufferPoolManagerInstance
+  BufferPoolManager *bpm = this->GetBufferPoolManager(page_id);
+  return bpm->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) {
+  // Flush page_id from responsible BufferPoolManagerInstance
+  BufferPoolManager *bpm = this->GetBufferPoolManager(page_id);
+  return bpm->FlushPage(page_id);
+}
+
+Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
+  // create new page. We will request page allocation in a round robin manner from the underlying
+  // BufferPoolManagerInstances
+  // 1.   From a starting index of the BPMIs, call NewPageImpl until either 1) success and return 2) looped around to
+  // starting index and return nullptr
+  // 2.   Bump the starting index (mod number of instances) to start search at a different BPMI each time this function
+  // is called
+  Page *my_page = nullptr;
+  for (uint32_t idx = start_idx_; idx < start_idx_ + num_instances_; idx++) {
+    my_page = bpm_list_[idx % num_instances_]->NewPage(page_id);
+    if (my_page != nullptr) {
+      // Success
+      break;
+    }
+  }
+  start_idx_ = (start_idx_ + 1) % num_instances_;
+  return my_page;
+}
+
+bool ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) {
+  // Delete page_id from responsible BufferPoolManagerInstance
+  BufferPoolManager *bpm = this->GetBufferPoolManager(page_id);
+  return bpm->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  // flush all pages from all BufferPoolManagerInstances
+  for (auto it : bpm_list_) {
+    it->FlushAllPages();
+  }
+}
+
+}  // namespace bustub
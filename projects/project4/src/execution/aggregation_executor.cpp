@@ -0,0 +1,246 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <limits>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx), aht_(plan->GetAggregates(), plan->GetAggregateTypes()), aht_iterator_(aht_.Begin()) {
+  plan_ = plan;
+  child_ = std::move(child);
+}
+
+void AggregationExecutor::Init() {
+  BUSTUB_ASSERT(child_ != nullptr, "The child executor is a nullptr.");
+  child_->Init();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  aht_.Clear();
+  spill_runs_.clear();
+  spilled_partitions_.clear();
+  merged_tables_.clear();
+  merged_table_idx_ = 0;
+  output_table_ = &aht_;
+  size_t num_threads = exec_ctx_->GetDegreeOfParallelism();
+  if (num_threads > 1 && (worker_pool_ == nullptr || worker_pool_->GetNumThreads() != num_threads)) {
+    worker_pool_ = std::make_unique<WorkerPool>(num_threads);
+  }
+  if (num_threads > 1 && ParallelAggregate()) {
+    output_table_ = merged_tables_[0].get();
+    aht_iterator_ = output_table_->Begin();
+    return;
+  }
+  TupleBatch batch;
+  // Phase #1: Build the aggregation hash table
+  // Gather the results produced by a child executor, a batch at a time
+  while (child_->NextBatch(&batch)) {
+    for (uint32_t row_idx : batch.GetSelection()) {
+      // This statement performs group by automatically
+      AggregateKey agg_key = MakeAggregateKey(batch, row_idx);
+      AggregateValue *agg_val = aht_.FindOrInsert(agg_key, memory_budget_);
+      if (agg_val != nullptr) {
+        aht_.CombineAggregateValues(agg_val, MakeAggregateValue(batch, row_idx));
+      } else {
+        SpillTuple(agg_key, batch.MaterializeRow(row_idx), 0);
+      }
+    }
+  }
+  FinishSpilling(0);
+  // Initialize the aggregation hash table iterator
+  aht_iterator_ = aht_.Begin();
+}
+
+bool AggregationExecutor::ParallelAggregate() {
+  size_t num_threads = exec_ctx_->GetDegreeOfParallelism();
+  std::vector<std::unique_ptr<SimpleAggregationHashTable>> thread_tables(num_threads);
+  for (auto &table : thread_tables) {
+    table = std::make_unique<SimpleAggregationHashTable>(plan_->GetAggregates(), plan_->GetAggregateTypes());
+  }
+  // Phase #1: every thread pulls child batches and aggregates them into its own table. The child is only
+  // called by one thread at a time, the batches are aggregated concurrently
+  std::mutex child_latch;
+  bool child_exhausted = false;
+  bool out_of_memory = false;
+  size_t memory_usage = 0;
+  worker_pool_->Run(num_threads, [&](size_t worker) {
+    SimpleAggregationHashTable *table = thread_tables[worker].get();
+    size_t table_memory_usage = 0;
+    TupleBatch batch;
+    while (true) {
+      {
+        std::scoped_lock latch(child_latch);
+        memory_usage += table->GetMemoryUsage() - table_memory_usage;
+        table_memory_usage = table->GetMemoryUsage();
+        out_of_memory = out_of_memory || memory_usage > memory_budget_;
+        if (child_exhausted || out_of_memory) {
+          return;
+        }
+        // A child that throws counts as exhausted, so the other threads do not pull from it again
+        child_exhausted = true;
+        child_exhausted = !child_->NextBatch(&batch);
+        if (child_exhausted) {
+          return;
+        }
+      }
+      AggregateMorsel(batch, table);
+    }
+  });
+
+  if (!child_exhausted) {
+    // Out of memory, the rest of the child goes through aht_ on the calling thread
+    for (const auto &table : thread_tables) {
+      for (auto iter = table->Begin(); iter != table->End(); ++iter) {
+        aht_.MergeAggregateValues(aht_.FindOrInsert(iter.Key(), std::numeric_limits<size_t>::max()), iter.Val());
+      }
+    }
+    return false;
+  }
+
+  // Phase #2: every thread merges the groups of one hash partition from all thread tables
+  merged_tables_.resize(num_threads);
+  worker_pool_->Run(num_threads, [&](size_t partition_idx) {
+    auto merged_table =
+        std::make_unique<SimpleAggregationHashTable>(plan_->GetAggregates(), plan_->GetAggregateTypes());
+    for (const auto &table : thread_tables) {
+      for (auto iter = table->Begin(); iter != table->End(); ++iter) {
+        if (std::hash<AggregateKey>{}(iter.Key()) % num_threads == partition_idx) {
+          merged_table->MergeAggregateValues(merged_table->FindOrInsert(iter.Key(), std::numeric_limits<size_t>::max()),
+                                             iter.Val());
+        }
+      }
+    }
+    merged_tables_[partition_idx] = std::move(merged_table);
+  });
+  return true;
+}
+
+void AggregationExecutor::AggregateMorsel(const TupleBatch &batch, SimpleAggregationHashTable *table) {
+  for (uint32_t row_idx : batch.GetSelection()) {
+    AggregateKey agg_key = MakeAggregateKey(batch, row_idx);
+    table->CombineAggregateValues(table->FindOrInsert(agg_key, std::numeric_limits<size_t>::max()),
+                                  MakeAggregateValue(batch, row_idx));
+  }
+}
+
+void AggregationExecutor::SpillTuple(const AggregateKey &agg_key, const Tuple &tuple, uint32_t level) {
+  if (spill_runs_.empty()) {
+    spill_runs_.resize(PARTITION_FANOUT);
+  }
+  size_t partition_idx = SpillPartitionOf(std::hash<AggregateKey>{}(agg_key), level, PARTITION_FANOUT);
+  std::unique_ptr<TmpTupleRun> &run = spill_runs_[partition_idx];
+  if (run == nullptr) {
+    run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  }
+  run->Append(tuple);
+}
+
+void AggregationExecutor::FinishSpilling(uint32_t level) {
+  for (auto &run : spill_runs_) {
+    if (run != nullptr) {
+      run->FinishWrite();
+      spilled_partitions_.emplace_back(SpilledPartition{std::move(run), level + 1});
+    }
+  }
+  spill_runs_.clear();
+}
+
+bool AggregationExecutor::LoadGroups() {
+  while (aht_iterator_ == output_table_->End()) {
+    if (merged_table_idx_ + 1 < merged_tables_.size()) {
+      // Hand out the groups of the next partition of a parallel aggregation
+      output_table_ = merged_tables_[++merged_table_idx_].get();
+      aht_iterator_ = output_table_->Begin();
+      continue;
+    }
+    if (spilled_partitions_.empty()) {
+      return false;
+    }
+    // Aggregate the next spilled partition, its groups are disjoint from the ones handed out so far
+    SpilledPartition partition = std::move(spilled_partitions_.front());
+    spilled_partitions_.pop_front();
+    size_t memory_budget = partition.level_ < MAX_PARTITION_LEVEL ? memory_budget_ : std::numeric_limits<size_t>::max();
+    aht_.Clear();
+    output_table_ = &aht_;
+    Tuple tuple;
+    partition.run_->BeginRead();
+    while (partition.run_->Next(&tuple)) {
+      AggregateKey agg_key = MakeAggregateKey(&tuple);
+      AggregateValue *agg_val = aht_.FindOrInsert(agg_key, memory_budget);
+      if (agg_val != nullptr) {
+        aht_.CombineAggregateValues(agg_val, MakeAggregateValue(&tuple));
+      } else {
+        SpillTuple(agg_key, tuple, partition.level_);
+      }
+    }
+    FinishSpilling(partition.level_);
+    aht_iterator_ = aht_.Begin();
+  }
+  return true;
+}
+
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  std::vector<Value> output_values;
+  const Schema *output_schema = GetOutputSchema();
+  // A single having clause
+  // Iterate through the hash table to find tuples satisfying the having clause
+  while (LoadGroups()) {
+    if (plan_->GetHaving() == nullptr ||
+        plan_->GetHaving()
+            ->EvaluateAggregate(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_)
+            .GetAs<bool>()) {
+      // The current tuple satisfy the having clause
+      // Emit it
+      output_values.clear();
+      for (auto &col : output_schema->GetColumns()) {
+        output_values.emplace_back(
+            col.GetExpr()->EvaluateAggregate(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_));
+      }
+      *tuple = Tuple(output_values, output_schema);
+      ++aht_iterator_;
+      return true;
+    }
+    // Check the next tuple
+    ++aht_iterator_;
+  }
+  // In the case that we cannot find a tuple satisfying the having clause
+  // Or there are no more groups
+  return false;
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  const Schema *output_schema = GetOutputSchema();
+  std::vector<Value> output_values(output_schema->GetColumnCount());
+  batch->Reset(output_schema);
+  while (!batch->IsFull() && LoadGroups()) {
+    const AggregateKey &agg_key = aht_iterator_.Key();
+    const AggregateValue &agg_val = aht_iterator_.Val();
+    if (plan_->GetHaving() == nullptr ||
+        plan_->GetHaving()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_).GetAs<bool>()) {
+      for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+        output_values[col_idx] =
+            output_schema->GetColumn(col_idx).GetExpr()->EvaluateAggregate(agg_key.group_bys_, agg_val.aggregates_);
+      }
+      batch->AppendValues(output_values, RID{});
+    }
+    ++aht_iterator_;
+  }
+  return !batch->IsEmpty();
+}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+}  // namespace bustub
@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.cpp
+//
+// Identification: src/execution/compiled_predicate.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_predicate.h"
+
+#include <limits>
+#include <type_traits>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether a type is an integer type, the only ones comparisons are lowered for */
+bool IsIntegerType(TypeId type) {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/** @return the comparison with its operands swapped */
+ComparisonType MirrorComparison(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+}  // namespace
+
+CompiledPredicate::CompiledPredicate(const AbstractExpression *predicate, const Schema *schema) {
+  predicate_ = predicate;
+  left_schema_ = schema;
+  Lower(predicate);
+}
+
+CompiledPredicate::CompiledPredicate(const AbstractExpression *predicate, const Schema *left_schema,
+                                     const Schema *right_schema) {
+  predicate_ = predicate;
+  is_join_ = true;
+  left_schema_ = left_schema;
+  right_schema_ = right_schema;
+  Lower(predicate);
+}
+
+void CompiledPredicate::Lower(const AbstractExpression *predicate) {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+  if (comparison == nullptr) {
+    return;
+  }
+  const AbstractExpression *left = comparison->GetChildAt(0);
+  const AbstractExpression *right = comparison->GetChildAt(1);
+  ComparisonType comp_type = comparison->GetComparisonType();
+  TypeId left_type;
+  // INVALID stands for a constant right operand
+  TypeId right_type = TypeId::INVALID;
+  if (ResolveColumn(left, &lhs_, &left_type)) {
+    if (!ResolveColumn(right, &rhs_, &right_type) && !ResolveConstant(right)) {
+      return;
+    }
+  } else if (ResolveColumn(right, &lhs_, &left_type) && ResolveConstant(left)) {
+    // The constant is on the left, compare the column with it the other way around
+    comp_type = MirrorComparison(comp_type);
+  } else {
+    return;
+  }
+  switch (left_type) {
+    case TypeId::TINYINT:
+      compare_ = PickRightType<int8_t>(right_type, comp_type);
+      break;
+    case TypeId::SMALLINT:
+      compare_ = PickRightType<int16_t>(right_type, comp_type);
+      break;
+    case TypeId::INTEGER:
+      compare_ = PickRightType<int32_t>(right_type, comp_type);
+      break;
+    default:
+      compare_ = PickRightType<int64_t>(right_type, comp_type);
+      break;
+  }
+}
+
+bool CompiledPredicate::ResolveColumn(const AbstractExpression *expr, ColumnOperand *operand, TypeId *type) const {
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr);
+  if (column_expr == nullptr) {
+    return false;
+  }
+  // Evaluate() reads every column from its single tuple, EvaluateJoin() picks the tuple of the column
+  uint32_t tuple_idx = is_join_ ? column_expr->GetTupleIdx() : 0;
+  const Schema *schema = tuple_idx == 0 ? left_schema_ : right_schema_;
+  if (column_expr->GetColIdx() >= schema->GetColumnCount()) {
+    return false;
+  }
+  const Column &column = schema->GetColumn(column_expr->GetColIdx());
+  if (!IsIntegerType(column.GetType())) {
+    return false;
+  }
+  operand->tuple_idx_ = tuple_idx;
+  operand->offset_ = column.GetOffset();
+  *type = column.GetType();
+  return true;
+}
+
+bool CompiledPredicate::ResolveConstant(const AbstractExpression *expr) {
+  if (dynamic_cast<const ConstantValueExpression *>(expr) == nullptr) {
+    return false;
+  }
+  Value value = expr->Evaluate(nullptr, nullptr);
+  if (value.IsNull() || !IsIntegerType(value.GetTypeId())) {
+    return false;
+  }
+  // Value::GetAs() reinterprets the storage of the value, so a narrow integer is read with its own width
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      constant_ = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      constant_ = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      constant_ = value.GetAs<int32_t>();
+      break;
+    default:
+      constant_ = value.GetAs<int64_t>();
+      break;
+  }
+  return true;
+}
+
+template <typename L>
+CompiledPredicate::CompareFunction CompiledPredicate::PickRightType(TypeId right_type, ComparisonType comp_type) {
+  switch (right_type) {
+    case TypeId::INVALID:
+      return PickComparison<L, ConstantOperand>(comp_type);
+    case TypeId::TINYINT:
+      return PickComparison<L, int8_t>(comp_type);
+    case TypeId::SMALLINT:
+      return PickComparison<L, int16_t>(comp_type);
+    case TypeId::INTEGER:
+      return PickComparison<L, int32_t>(comp_type);
+    default:
+      return PickComparison<L, int64_t>(comp_type);
+  }
+}
+
+template <typename L, typename R>
+CompiledPredicate::CompareFunction CompiledPredicate::PickComparison(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return &Compare<L, R, ComparisonType::Equal>;
+    case ComparisonType::NotEqual:
+      return &Compare<L, R, ComparisonType::NotEqual>;
+    case ComparisonType::LessThan:
+      return &Compare<L, R, ComparisonType::LessThan>;
+    case ComparisonType::LessThanOrEqual:
+      return &Compare<L, R, ComparisonType::LessThanOrEqual>;
+    case ComparisonType::GreaterThan:
+      return &Compare<L, R, ComparisonType::GreaterThan>;
+    case ComparisonType::GreaterThanOrEqual:
+      return &Compare<L, R, ComparisonType::GreaterThanOrEqual>;
+    default:
+      return nullptr;
+  }
+}
+
+template <typename L, typename R, ComparisonType CMP>
+bool CompiledPredicate::Compare(const CompiledPredicate &pred, const Tuple *left_tuple, const Tuple *right_tuple) {
+  // A NULL integer is stored as the smallest value of its type, the interpreted comparison decides what it yields
+  L lhs = ReadColumn<L>(pred.lhs_, left_tuple, right_tuple);
+  if (lhs == std::numeric_limits<L>::min()) {
+    return pred.Interpret(left_tuple, right_tuple);
+  }
+  int64_t rhs = pred.constant_;
+  if constexpr (!std::is_same_v<R, ConstantOperand>) {
+    R raw_rhs = ReadColumn<R>(pred.rhs_, left_tuple, right_tuple);
+    if (raw_rhs == std::numeric_limits<R>::min()) {
+      return pred.Interpret(left_tuple, right_tuple);
+    }
+    rhs = raw_rhs;
+  }
+  // Both operands are widened, like Value compares integers of different types
+  auto wide_lhs = static_cast<int64_t>(lhs);
+  if constexpr (CMP == ComparisonType::Equal) {
+    return wide_lhs == rhs;
+  } else if constexpr (CMP == ComparisonType::NotEqual) {
+    return wide_lhs != rhs;
+  } else if constexpr (CMP == ComparisonType::LessThan) {
+    return wide_lhs < rhs;
+  } else if constexpr (CMP == ComparisonType::LessThanOrEqual) {
+    return wide_lhs <= rhs;
+  } else if constexpr (CMP == ComparisonType::GreaterThan) {
+    return wide_lhs > rhs;
+  } else {
+    return wide_lhs >= rhs;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// distinct_executor.cpp
+//
+// Identification: src/execution/distinct_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/distinct_executor.h"
+
+namespace bustub {
+
+void HashDistinctTable::Insert(const SortKey &key, hash_t hash) {
+  // Keep the load factor at or below one half
+  if ((num_keys_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  size_t slot_idx = hash & (slots_.size() - 1);
+  while (slots_[slot_idx].key_offset_ != NO_KEY) {
+    slot_idx = (slot_idx + 1) & (slots_.size() - 1);
+  }
+  Slot &slot = slots_[slot_idx];
+  slot.hash_ = hash;
+  slot.key_offset_ = keys_.size();
+  uint32_t key_size = key.GetSize();
+  keys_.resize(keys_.size() + sizeof(uint32_t) + key_size);
+  memcpy(keys_.data() + slot.key_offset_, &key_size, sizeof(uint32_t));
+  memcpy(keys_.data() + slot.key_offset_ + sizeof(uint32_t), key.GetData(), key_size);
+  num_keys_++;
+}
+
+void HashDistinctTable::Grow() {
+  std::vector<Slot> old_slots(std::max<size_t>(slots_.size() * 2, 16));
+  slots_.swap(old_slots);
+  for (const auto &old_slot : old_slots) {
+    if (old_slot.key_offset_ == NO_KEY) {
+      continue;
+    }
+    size_t slot_idx = old_slot.hash_ & (slots_.size() - 1);
+    while (slots_[slot_idx].key_offset_ != NO_KEY) {
+      slot_idx = (slot_idx + 1) & (slots_.size() - 1);
+    }
+    slots_[slot_idx] = old_slot;
+  }
+}
+
+DistinctExecutor::DistinctExecutor(ExecutorContext *exec_ctx, const DistinctPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  child_executor_ = std::move(child_executor);
+}
+
+void DistinctExecutor::Init() {
+  // Init the left and right child executors
+  BUSTUB_ASSERT(child_executor_ != nullptr, "The child executor is a nullptr.");
+  child_executor_->Init();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  hash_table_.Clear();
+  child_exhausted_ = false;
+  partition_run_.reset();
+  level_ = 0;
+  spill_runs_.clear();
+  spilled_partitions_.clear();
+}
+
+bool DistinctExecutor::NextInput(Tuple *tuple, RID *rid) {
+  while (true) {
+    if (!child_exhausted_) {
+      if (child_executor_->Next(tuple, rid)) {
+        return true;
+      }
+      child_exhausted_ = true;
+      FinishSpilling();
+    } else if (partition_run_ != nullptr && partition_run_->Next(tuple)) {
+      *rid = tuple->GetRid();
+      return true;
+    } else {
+      if (partition_run_ != nullptr) {
+        FinishSpilling();
+      }
+      if (spilled_partitions_.empty()) {
+        return false;
+      }
+      // Read the next spilled partition, its keys are disjoint from the ones produced so far
+      SpilledPartition partition = std::move(spilled_partitions_.front());
+      spilled_partitions_.pop_front();
+      partition_run_ = std::move(partition.run_);
+      partition_run_->BeginRead();
+      level_ = partition.level_;
+      hash_table_.Clear();
+    }
+  }
+}
+
+void DistinctExecutor::SpillTuple(const Tuple &tuple, hash_t hash) {
+  if (spill_runs_.empty()) {
+    spill_runs_.resize(PARTITION_FANOUT);
+  }
+  size_t partition_idx = SpillPartitionOf(hash, level_, PARTITION_FANOUT);
+  std::unique_ptr<TmpTupleRun> &run = spill_runs_[partition_idx];
+  if (run == nullptr) {
+    run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  }
+  run->Append(tuple);
+}
+
+void DistinctExecutor::FinishSpilling() {
+  for (auto &run : spill_runs_) {
+    if (run != nullptr) {
+      run->FinishWrite();
+      spilled_partitions_.emplace_back(SpilledPartition{std::move(run), level_ + 1});
+    }
+  }
+  spill_runs_.clear();
+}
+
+bool DistinctExecutor::Next(Tuple *tuple, RID *rid) {
+  while (NextInput(tuple, rid)) {
+    MakeKey(*tuple);
+    hash_t hash = HashUtil::HashBytes(key_.GetData(), key_.GetSize());
+    if (hash_table_.Contains(key_, hash)) {
+      // A duplicate, dropped without copying anything
+      continue;
+    }
+    if (level_ < MAX_PARTITION_LEVEL && !hash_table_.HasRoom(key_, memory_budget_)) {
+      // The key has not been produced yet, the partition it is spilled to is deduplicated later
+      SpillTuple(*tuple, hash);
+      continue;
+    }
+    hash_table_.Insert(key_, hash);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
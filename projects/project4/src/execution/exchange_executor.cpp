@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.cpp
+//
+// Identification: src/execution/exchange_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/exchange_executor.h"
+
+#include "execution/executors/seq_scan_executor.h"
+
+namespace bustub {
+
+ExchangeExecutor::ExchangeExecutor(ExecutorContext *exec_ctx, std::vector<std::unique_ptr<AbstractExecutor>> &&workers,
+                                   std::unique_ptr<MorselCursor> &&cursor)
+    : AbstractExecutor(exec_ctx) {
+  BUSTUB_ASSERT(!workers.empty(), "An exchange needs at least one worker.");
+  workers_ = std::move(workers);
+  cursor_ = std::move(cursor);
+}
+
+ExchangeExecutor::~ExchangeExecutor() { StopWorkers(); }
+
+std::unique_ptr<AbstractExecutor> ExchangeExecutor::CreateParallelScan(ExecutorContext *exec_ctx,
+                                                                       const SeqScanPlanNode *plan) {
+  size_t num_workers = exec_ctx->GetDegreeOfParallelism();
+  if (num_workers <= 1) {
+    return std::make_unique<SeqScanExecutor>(exec_ctx, plan);
+  }
+  TableInfo *table_info = exec_ctx->GetCatalog()->GetTable(plan->GetTableOid());
+  auto cursor = std::make_unique<MorselCursor>(table_info->table_.get(), exec_ctx->GetBufferPoolManager());
+  std::vector<std::unique_ptr<AbstractExecutor>> workers;
+  for (size_t worker_idx = 0; worker_idx < num_workers; worker_idx++) {
+    workers.emplace_back(std::make_unique<SeqScanExecutor>(exec_ctx, plan, cursor.get()));
+  }
+  return std::make_unique<ExchangeExecutor>(exec_ctx, std::move(workers), std::move(cursor));
+}
+
+void ExchangeExecutor::Init() {
+  StopWorkers();
+  if (cursor_ != nullptr) {
+    cursor_->Reset();
+  }
+  for (auto &worker : workers_) {
+    worker->Init();
+  }
+  started_ = false;
+  queue_.clear();
+  stopping_ = false;
+  error_ = nullptr;
+  batch_.Reset(GetOutputSchema());
+  sel_idx_ = 0;
+}
+
+bool ExchangeExecutor::SetRuntimeFilter(const RuntimeFilter *filter) {
+  if (started_) {
+    // The workers read their filter without synchronization
+    return false;
+  }
+  bool applied = true;
+  for (auto &worker : workers_) {
+    applied = worker->SetRuntimeFilter(filter) && applied;
+  }
+  if (!applied) {
+    // Rows a worker keeps have to pass the same checks as the rows of the others
+    for (auto &worker : workers_) {
+      worker->SetRuntimeFilter(nullptr);
+    }
+  }
+  return applied;
+}
+
+void ExchangeExecutor::StartWorkers() {
+  started_ = true;
+  num_running_ = workers_.size();
+  threads_.reserve(workers_.size());
+  for (size_t worker_idx = 0; worker_idx < workers_.size(); worker_idx++) {
+    threads_.emplace_back(&ExchangeExecutor::RunWorker, this, worker_idx);
+  }
+}
+
+void ExchangeExecutor::StopWorkers() {
+  {
+    std::scoped_lock latch(latch_);
+    stopping_ = true;
+  }
+  not_full_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+void ExchangeExecutor::RunWorker(size_t worker_idx) {
+  AbstractExecutor *worker = workers_[worker_idx].get();
+  size_t queue_capacity = QUEUED_BATCHES_PER_WORKER * workers_.size();
+  try {
+    TupleBatch batch;
+    while (worker->NextBatch(&batch)) {
+      std::unique_lock<std::mutex> latch(latch_);
+      not_full_.wait(latch, [&] { return stopping_ || queue_.size() < queue_capacity; });
+      if (stopping_) {
+        break;
+      }
+      queue_.emplace_back(std::move(batch));
+      not_empty_.notify_one();
+    }
+  } catch (...) {
+    std::scoped_lock latch(latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+  }
+  std::scoped_lock latch(latch_);
+  num_running_--;
+  not_empty_.notify_all();
+}
+
+bool ExchangeExecutor::PullBatch(TupleBatch *batch) {
+  if (!started_) {
+    StartWorkers();
+  }
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> latch(latch_);
+    not_empty_.wait(latch, [&] { return !queue_.empty() || num_running_ == 0 || error_ != nullptr; });
+    if (error_ == nullptr) {
+      if (queue_.empty()) {
+        return false;
+      }
+      *batch = std::move(queue_.front());
+      queue_.pop_front();
+      not_full_.notify_one();
+      return true;
+    }
+    error = error_;
+  }
+  // A worker failed, the others are stopped before the error reaches the parent
+  StopWorkers();
+  std::rethrow_exception(error);
+}
+
+bool ExchangeExecutor::Next(Tuple *tuple, RID *rid) {
+  while (sel_idx_ == batch_.Size()) {
+    if (!PullBatch(&batch_)) {
+      return false;
+    }
+    sel_idx_ = 0;
+  }
+  uint32_t row_idx = batch_.GetSelection()[sel_idx_++];
+  *tuple = batch_.MaterializeRow(row_idx);
+  *rid = batch_.GetRid(row_idx);
+  return true;
+}
+
+bool ExchangeExecutor::NextBatch(TupleBatch *batch) {
+  if (!PullBatch(batch)) {
+    batch->Reset(GetOutputSchema());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace bustub
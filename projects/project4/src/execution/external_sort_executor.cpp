@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_executor.cpp
+//
+// Identification: src/execution/external_sort_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/external_sort_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ExternalSortExecutor::ExternalSortExecutor(ExecutorContext *exec_ctx,
+                                           std::unique_ptr<AbstractExecutor> &&child_executor,
+                                           std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys)
+    : AbstractExecutor(exec_ctx) {
+  child_executor_ = std::move(child_executor);
+  order_bys_ = std::move(order_bys);
+}
+
+void ExternalSortExecutor::MakeKey(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                                   const Tuple &tuple, const Schema *schema, SortKey *sort_key) {
+  sort_key->Clear();
+  for (const auto &[order_by_type, expr] : order_bys) {
+    sort_key->Append(expr->Evaluate(&tuple, schema), order_by_type);
+  }
+}
+
+void ExternalSortExecutor::Init() {
+  BUSTUB_ASSERT(child_executor_ != nullptr, "Child executor is null.");
+  child_executor_->Init();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  // Every run being merged pins its page being read, and the merged run its page being written
+  merge_fan_in_ = std::min(memory_budget_ / PAGE_SIZE, exec_ctx_->GetBufferPoolManager()->GetPoolSize() / 2);
+  merge_fan_in_ = std::max<size_t>(merge_fan_in_, 2);
+  entries_.clear();
+  entries_bytes_ = 0;
+  entry_idx_ = 0;
+  runs_.clear();
+  merge_sources_.clear();
+  loser_tree_.clear();
+
+  const Schema *child_schema = child_executor_->GetOutputSchema();
+  SortEntry entry;
+  RID rid;
+  while (child_executor_->Next(&entry.tuple_, &rid)) {
+    MakeKey(order_bys_, entry.tuple_, child_schema, &entry.key_);
+    entries_bytes_ += EntryMemoryUsage(entry);
+    entries_.emplace_back(std::move(entry));
+    if (entries_bytes_ > memory_budget_) {
+      SpillRun();
+    }
+  }
+
+  if (runs_.empty()) {
+    // The whole input fits into memory
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+    return;
+  }
+  if (!entries_.empty()) {
+    SpillRun();
+  }
+  MergeRunsToFanIn();
+  StartMerge(0, runs_.size());
+}
+
+void ExternalSortExecutor::SpillRun() {
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+  auto run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+  for (const SortEntry &entry : entries_) {
+    run->Append(entry.tuple_);
+  }
+  run->FinishWrite();
+  runs_.emplace_back(std::move(run));
+  entries_.clear();
+  entries_bytes_ = 0;
+}
+
+void ExternalSortExecutor::MergeRunsToFanIn() {
+  while (runs_.size() > merge_fan_in_) {
+    std::vector<std::unique_ptr<TmpTupleRun>> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += merge_fan_in_) {
+      size_t end = std::min(begin + merge_fan_in_, runs_.size());
+      if (end - begin == 1) {
+        merged_runs.emplace_back(std::move(runs_[begin]));
+        continue;
+      }
+      StartMerge(begin, end);
+      auto merged_run = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+      Tuple tuple;
+      while (MergeNext(&tuple)) {
+        merged_run->Append(tuple);
+      }
+      merged_run->FinishWrite();
+      merged_runs.emplace_back(std::move(merged_run));
+      // Delete the merged runs right away, so their pages can be reused by the next group
+      merge_sources_.clear();
+      for (size_t i = begin; i < end; i++) {
+        runs_[i].reset();
+      }
+    }
+    runs_ = std::move(merged_runs);
+  }
+}
+
+void ExternalSortExecutor::StartMerge(size_t begin, size_t end) {
+  merge_sources_.clear();
+  for (size_t i = begin; i < end; i++) {
+    runs_[i]->BeginRead();
+    merge_sources_.emplace_back(MergeSource{runs_[i].get(), SortKey{}, Tuple{}, false});
+    AdvanceSource(&merge_sources_.back());
+  }
+  loser_tree_.assign(merge_sources_.size(), 0);
+  loser_tree_[0] = BuildLoserTree(1);
+}
+
+size_t ExternalSortExecutor::BuildLoserTree(size_t node) {
+  size_t num_sources = merge_sources_.size();
+  if (node >= num_sources) {
+    return node - num_sources;
+  }
+  size_t left_winner = BuildLoserTree(2 * node);
+  size_t right_winner = BuildLoserTree(2 * node + 1);
+  if (SourceLess(right_winner, left_winner)) {
+    loser_tree_[node] = left_winner;
+    return right_winner;
+  }
+  loser_tree_[node] = right_winner;
+  return left_winner;
+}
+
+bool ExternalSortExecutor::MergeNext(Tuple *tuple) {
+  size_t winner = loser_tree_[0];
+  MergeSource &source = merge_sources_[winner];
+  if (source.exhausted_) {
+    // The winner is only exhausted once every source is
+    return false;
+  }
+  *tuple = std::move(source.tuple_);
+  AdvanceSource(&source);
+  // Replay the matches on the path from the source to the root, the winner of each one moves up
+  size_t num_sources = merge_sources_.size();
+  for (size_t node = (winner + num_sources) / 2; node > 0; node /= 2) {
+    if (SourceLess(loser_tree_[node], winner)) {
+      std::swap(loser_tree_[node], winner);
+    }
+  }
+  loser_tree_[0] = winner;
+  return true;
+}
+
+void ExternalSortExecutor::AdvanceSource(MergeSource *source) {
+  if (!source->run_->Next(&source->tuple_)) {
+    source->exhausted_ = true;
+    return;
+  }
+  MakeKey(order_bys_, source->tuple_, child_executor_->GetOutputSchema(), &source->key_);
+}
+
+bool ExternalSortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (runs_.empty()) {
+    if (entry_idx_ == entries_.size()) {
+      return false;
+    }
+    *tuple = std::move(entries_[entry_idx_++].tuple_);
+  } else if (!MergeNext(tuple)) {
+    return false;
+  }
+  *rid = tuple->GetRid();
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,581 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void HashJoinTable::Insert(const HashJoinKey &hash_key, const Tuple &tuple) {
+  // Keep the load factor at or below one half
+  if ((num_keys_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  size_t slot_idx = hash_key.GetHash() & (slots_.size() - 1);
+  while (slots_[slot_idx].first_entry_ != NO_ENTRY &&
+         !(slots_[slot_idx].hash_ == hash_key.GetHash() && KeyEquals(slots_[slot_idx], hash_key))) {
+    slot_idx = (slot_idx + 1) & (slots_.size() - 1);
+  }
+  Slot &slot = slots_[slot_idx];
+  if (slot.first_entry_ == NO_ENTRY) {
+    // A new key
+    slot.hash_ = hash_key.GetHash();
+    slot.key_offset_ = keys_.size();
+    uint32_t key_size = hash_key.GetSize();
+    keys_.resize(keys_.size() + sizeof(uint32_t) + key_size);
+    memcpy(keys_.data() + slot.key_offset_, &key_size, sizeof(uint32_t));
+    memcpy(keys_.data() + slot.key_offset_ + sizeof(uint32_t), hash_key.GetData(), key_size);
+    num_keys_++;
+  }
+  // Append the entry to the arena and make it the head of the chain of its key
+  size_t entry = arena_.size();
+  arena_.resize(entry + sizeof(size_t) + sizeof(uint32_t) + tuple.GetLength());
+  memcpy(arena_.data() + entry, &slot.first_entry_, sizeof(size_t));
+  tuple.SerializeTo(arena_.data() + entry + sizeof(size_t));
+  slot.first_entry_ = entry;
+  num_tuples_++;
+}
+
+void HashJoinTable::Grow() {
+  std::vector<Slot> old_slots(std::max<size_t>(slots_.size() * 2, 16));
+  slots_.swap(old_slots);
+  for (const auto &old_slot : old_slots) {
+    if (old_slot.first_entry_ == NO_ENTRY) {
+      continue;
+    }
+    size_t slot_idx = old_slot.hash_ & (slots_.size() - 1);
+    while (slots_[slot_idx].first_entry_ != NO_ENTRY) {
+      slot_idx = (slot_idx + 1) & (slots_.size() - 1);
+    }
+    slots_[slot_idx] = old_slot;
+  }
+}
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_child,
+                                   std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  left_child_ = std::move(left_child);
+  right_child_ = std::move(right_child);
+  // The plan node has a single key expression per side, the table takes any number of key columns
+  left_key_exprs_ = {plan_->LeftJoinKeyExpression()};
+  right_key_exprs_ = {plan_->RightJoinKeyExpression()};
+}
+
+void HashJoinExecutor::MakeKey(const std::vector<const AbstractExpression *> &key_exprs, const TupleBatch &batch,
+                               uint32_t row_idx, HashJoinKey *hash_key) {
+  hash_key->Clear();
+  for (const auto *key_expr : key_exprs) {
+    hash_key->Append(batch.EvaluateAt(key_expr, row_idx));
+  }
+}
+
+void HashJoinExecutor::MakeKey(const std::vector<const AbstractExpression *> &key_exprs, const Tuple &tuple,
+                               const Schema *schema, HashJoinKey *hash_key) {
+  hash_key->Clear();
+  for (const auto *key_expr : key_exprs) {
+    hash_key->Append(key_expr->Evaluate(&tuple, schema));
+  }
+}
+
+void HashJoinExecutor::Init() {
+  // Init the left and right child executors
+  BUSTUB_ASSERT(left_child_ != nullptr, "Left child executor is null.");
+  BUSTUB_ASSERT(right_child_ != nullptr, "Right child executor is null.");
+  left_child_->Init();
+  right_child_->Init();
+  // Phase #1: Build the hash table, a batch of left tuples at a time
+  // Init may run again, e.g. as the inner side of a nested loop join, so start from an empty table
+  hash_table_ = HashJoinTable();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  resident_bytes_ = 0;
+  spilled_probe_run_.reset();
+  spilled_partitions_.clear();
+  partitions_.clear();
+  degree_of_parallelism_ = exec_ctx_->GetDegreeOfParallelism();
+  if (degree_of_parallelism_ > 1 &&
+      (worker_pool_ == nullptr || worker_pool_->GetNumThreads() != degree_of_parallelism_)) {
+    worker_pool_ = std::make_unique<WorkerPool>(degree_of_parallelism_);
+  }
+  std::vector<TupleBatch> left_batches;
+  bool left_exhausted = false;
+  if (degree_of_parallelism_ > 1) {
+    // Buffer the left side while it fits into the budget, a resident build side is built in parallel
+    uint32_t row_length = left_child_->GetOutputSchema()->GetLength();
+    size_t buffered_bytes = 0;
+    TupleBatch left_batch;
+    while (buffered_bytes <= memory_budget_ && !left_exhausted) {
+      left_exhausted = !left_child_->NextBatch(&left_batch);
+      if (!left_exhausted) {
+        buffered_bytes += HashJoinTable::EstimateMemoryUsage(left_batch.Size(), left_batch.Size() * row_length);
+        left_batches.emplace_back(std::move(left_batch));
+      }
+    }
+    if (left_exhausted && buffered_bytes <= memory_budget_) {
+      ParallelBuild(&left_batches);
+      left_batches.clear();
+    }
+  }
+  // Otherwise build on this thread, starting with the buffered batches
+  TupleBatch left_batch;
+  HashJoinKey left_hash_key;
+  size_t batch_idx = 0;
+  while (batch_idx < left_batches.size() || (!left_exhausted && left_child_->NextBatch(&left_batch))) {
+    const TupleBatch &batch = batch_idx < left_batches.size() ? left_batches[batch_idx++] : left_batch;
+    for (uint32_t row_idx : batch.GetSelection()) {
+      // Get the key by evaluating the left key expressions, a NULL key never joins
+      MakeKey(left_key_exprs_, batch, row_idx, &left_hash_key);
+      if (!left_hash_key.HasNull()) {
+        BuildTuple(left_hash_key, batch.MaterializeRow(row_idx));
+      }
+    }
+  }
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ != nullptr) {
+      partition.build_run_->FinishWrite();
+    }
+  }
+  // Phase #2 is pipelined: Next() and NextBatch() probe right tuples as they are pulled.
+  // Output columns that just copy a column are read straight from the hash table or the right batch,
+  // a row is only materialized if some output column is not a plain column reference
+  const Schema *output_schema = GetOutputSchema();
+  left_columns_.assign(output_schema->GetColumnCount(), nullptr);
+  right_columns_.assign(output_schema->GetColumnCount(), nullptr);
+  needs_left_tuple_ = false;
+  needs_right_tuple_ = false;
+  for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(output_schema->GetColumn(col_idx).GetExpr());
+    if (column_expr == nullptr) {
+      needs_left_tuple_ = true;
+      needs_right_tuple_ = true;
+    } else if (column_expr->GetTupleIdx() == 0) {
+      left_columns_[col_idx] = column_expr;
+    } else {
+      right_columns_[col_idx] = column_expr;
+    }
+  }
+  output_values_.resize(output_schema->GetColumnCount());
+  right_batch_.Reset(right_child_->GetOutputSchema());
+  right_sel_idx_ = 0;
+  right_exhausted_ = false;
+  left_match_table_ = nullptr;
+  left_match_entry_ = HashJoinTable::NO_ENTRY;
+  // Filter the right side and probe in parallel once the whole build side is resident
+  bool build_resident = std::none_of(partitions_.begin(), partitions_.end(), [](const HashJoinPartition &partition) {
+    return partition.build_run_ != nullptr;
+  });
+  runtime_filter_.reset();
+  if (build_resident) {
+    PushDownRuntimeFilter();
+  } else {
+    right_child_->SetRuntimeFilter(nullptr);
+  }
+  parallel_probe_ = degree_of_parallelism_ > 1 && build_resident;
+  probe_batches_.resize(degree_of_parallelism_);
+  probe_outputs_.resize(degree_of_parallelism_);
+  gathered_batches_.clear();
+  gathered_sel_idx_ = 0;
+}
+
+void HashJoinExecutor::PushDownRuntimeFilter() {
+  std::vector<const HashJoinTable *> tables{&hash_table_};
+  for (const auto &partition : partitions_) {
+    tables.emplace_back(&partition.table_);
+  }
+  size_t num_keys = 0;
+  for (const auto *table : tables) {
+    num_keys += table->GetNumKeys();
+  }
+  runtime_filter_ = std::make_unique<RuntimeFilter>(right_key_exprs_, num_keys);
+  for (const auto *table : tables) {
+    for (auto iter = table->Begin(); iter != table->End(); ++iter) {
+      runtime_filter_->Insert(iter.Hash());
+    }
+  }
+  if (!right_child_->SetRuntimeFilter(runtime_filter_.get())) {
+    // The right child cannot use it, the probe finds out about misses anyway
+    runtime_filter_.reset();
+  }
+}
+
+void HashJoinExecutor::ParallelBuild(std::vector<TupleBatch> *left_batches) {
+  size_t num_workers = degree_of_parallelism_;
+  partitions_.resize(num_workers);
+  // Pass #1: Every worker hashes a share of the batches and scatters the rows by partition, freeing every
+  // batch once it is scattered so the left side is not held twice
+  std::vector<std::vector<std::vector<std::pair<HashJoinKey, Tuple>>>> scattered(
+      num_workers, std::vector<std::vector<std::pair<HashJoinKey, Tuple>>>(num_workers));
+  worker_pool_->Run(num_workers, [&](size_t worker) {
+    HashJoinKey left_hash_key;
+    for (size_t batch_idx = worker; batch_idx < left_batches->size(); batch_idx += num_workers) {
+      TupleBatch &left_batch = (*left_batches)[batch_idx];
+      for (uint32_t row_idx : left_batch.GetSelection()) {
+        MakeKey(left_key_exprs_, left_batch, row_idx, &left_hash_key);
+        if (!left_hash_key.HasNull()) {
+          scattered[worker][PartitionOf(left_hash_key, 0, num_workers)].emplace_back(
+              left_hash_key, left_batch.MaterializeRow(row_idx));
+        }
+      }
+      left_batch = TupleBatch();
+    }
+  });
+  // Pass #2: Every worker builds the table of one partition, so the tables need no latches. The scattered
+  // rows are freed as soon as they are in the table
+  worker_pool_->Run(num_workers, [&](size_t worker) {
+    HashJoinTable &table = partitions_[worker].table_;
+    for (auto &rows : scattered) {
+      for (const auto &row : rows[worker]) {
+        table.Insert(row.first, row.second);
+      }
+      std::vector<std::pair<HashJoinKey, Tuple>>().swap(rows[worker]);
+    }
+  });
+  for (const auto &partition : partitions_) {
+    resident_bytes_ += partition.table_.GetMemoryUsage();
+  }
+}
+
+void HashJoinExecutor::BuildTuple(const HashJoinKey &hash_key, const Tuple &left_tuple) {
+  HashJoinTable *table = &hash_table_;
+  if (!partitions_.empty()) {
+    HashJoinPartition &partition = partitions_[PartitionOf(hash_key, 0, partitions_.size())];
+    if (partition.build_run_ != nullptr) {
+      partition.build_run_->Append(left_tuple);
+      return;
+    }
+    table = &partition.table_;
+  }
+  size_t old_memory_usage = table->GetMemoryUsage();
+  table->Insert(hash_key, left_tuple);
+  resident_bytes_ += table->GetMemoryUsage() - old_memory_usage;
+  if (resident_bytes_ > memory_budget_) {
+    if (partitions_.empty()) {
+      SplitIntoPartitions();
+    }
+    while (resident_bytes_ > memory_budget_ && SpillLargestPartition()) {
+    }
+  }
+}
+
+void HashJoinExecutor::SplitIntoPartitions() {
+  partitions_.resize(PARTITION_FANOUT);
+  HashJoinKey hash_key;
+  Tuple left_tuple;
+  for (auto iter = hash_table_.Begin(); iter != hash_table_.End(); ++iter) {
+    iter.Key(&hash_key);
+    HashJoinTable &table = partitions_[PartitionOf(hash_key, 0, PARTITION_FANOUT)].table_;
+    for (size_t entry = iter.FirstEntry(); entry != HashJoinTable::NO_ENTRY; entry = hash_table_.NextEntry(entry)) {
+      hash_table_.GetTuple(entry, &left_tuple);
+      table.Insert(hash_key, left_tuple);
+    }
+  }
+  hash_table_ = HashJoinTable();
+  resident_bytes_ = 0;
+  for (const auto &partition : partitions_) {
+    resident_bytes_ += partition.table_.GetMemoryUsage();
+  }
+}
+
+bool HashJoinExecutor::SpillLargestPartition() {
+  HashJoinPartition *largest = nullptr;
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ == nullptr &&
+        (largest == nullptr || partition.table_.GetMemoryUsage() > largest->table_.GetMemoryUsage())) {
+      largest = &partition;
+    }
+  }
+  if (largest == nullptr) {
+    return false;
+  }
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  largest->build_run_ = std::make_unique<TmpTupleRun>(bpm);
+  largest->probe_run_ = std::make_unique<TmpTupleRun>(bpm);
+  Tuple left_tuple;
+  for (auto iter = largest->table_.Begin(); iter != largest->table_.End(); ++iter) {
+    for (size_t entry = iter.FirstEntry(); entry != HashJoinTable::NO_ENTRY;
+         entry = largest->table_.NextEntry(entry)) {
+      largest->table_.GetTuple(entry, &left_tuple);
+      largest->build_run_->Append(left_tuple);
+    }
+  }
+  resident_bytes_ -= largest->table_.GetMemoryUsage();
+  largest->table_ = HashJoinTable();
+  return true;
+}
+
+void HashJoinExecutor::FinishPartitionedProbe() {
+  for (auto &partition : partitions_) {
+    if (partition.build_run_ != nullptr) {
+      partition.probe_run_->FinishWrite();
+      spilled_partitions_.push_back(
+          SpilledPartition{std::move(partition.build_run_), std::move(partition.probe_run_), 0});
+    }
+  }
+  // The resident partitions are fully joined
+  partitions_.clear();
+  resident_bytes_ = 0;
+}
+
+bool HashJoinExecutor::LoadNextSpilledPartition() {
+  spilled_probe_run_.reset();
+  hash_table_ = HashJoinTable();
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  while (!spilled_partitions_.empty()) {
+    SpilledPartition spilled_partition = std::move(spilled_partitions_.back());
+    spilled_partitions_.pop_back();
+    // A partition without tuples on either side produces no join results
+    if (spilled_partition.build_run_->GetNumTuples() == 0 || spilled_partition.probe_run_->GetNumTuples() == 0) {
+      continue;
+    }
+    // Partition again if the build side does not fit, unless it is likely dominated by a single key
+    if (EstimateSize(*spilled_partition.build_run_) > memory_budget_ &&
+        spilled_partition.level_ < MAX_PARTITION_LEVEL) {
+      SplitSpilledPartition(&spilled_partition);
+      continue;
+    }
+    Tuple left_tuple;
+    HashJoinKey left_hash_key;
+    spilled_partition.build_run_->BeginRead();
+    while (spilled_partition.build_run_->Next(&left_tuple)) {
+      MakeKey(left_key_exprs_, left_tuple, left_schema, &left_hash_key);
+      hash_table_.Insert(left_hash_key, left_tuple);
+    }
+    spilled_probe_run_ = std::move(spilled_partition.probe_run_);
+    spilled_probe_run_->BeginRead();
+    return true;
+  }
+  return false;
+}
+
+void HashJoinExecutor::SplitSpilledPartition(SpilledPartition *spilled_partition) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  uint32_t level = spilled_partition->level_ + 1;
+  std::vector<SpilledPartition> children;
+  children.reserve(PARTITION_FANOUT);
+  for (uint32_t i = 0; i < PARTITION_FANOUT; i++) {
+    children.push_back(SpilledPartition{std::make_unique<TmpTupleRun>(bpm), std::make_unique<TmpTupleRun>(bpm), level});
+  }
+  Tuple tuple;
+  HashJoinKey hash_key;
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  spilled_partition->build_run_->BeginRead();
+  while (spilled_partition->build_run_->Next(&tuple)) {
+    MakeKey(left_key_exprs_, tuple, left_schema, &hash_key);
+    children[PartitionOf(hash_key, level, PARTITION_FANOUT)].build_run_->Append(tuple);
+  }
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  spilled_partition->probe_run_->BeginRead();
+  while (spilled_partition->probe_run_->Next(&tuple)) {
+    MakeKey(right_key_exprs_, tuple, right_schema, &hash_key);
+    children[PartitionOf(hash_key, level, PARTITION_FANOUT)].probe_run_->Append(tuple);
+  }
+  for (auto &child : children) {
+    child.build_run_->FinishWrite();
+    child.probe_run_->FinishWrite();
+    spilled_partitions_.push_back(std::move(child));
+  }
+}
+
+bool HashJoinExecutor::AdvanceProbe() {
+  HashJoinKey right_hash_key;
+  while (left_match_entry_ == HashJoinTable::NO_ENTRY) {
+    // Phase #3: Probe the loaded spilled partition with its spilled right tuples
+    if (spilled_probe_run_ != nullptr) {
+      if (!spilled_probe_run_->Next(&right_tuple_)) {
+        if (!LoadNextSpilledPartition()) {
+          return false;
+        }
+        continue;
+      }
+      MakeKey(right_key_exprs_, right_tuple_, right_child_->GetOutputSchema(), &right_hash_key);
+      left_match_table_ = &hash_table_;
+      left_match_entry_ = hash_table_.Find(right_hash_key);
+      continue;
+    }
+    // Pull the next right batch once the current one is probed
+    if (right_sel_idx_ == right_batch_.Size()) {
+      if (right_exhausted_) {
+        return false;
+      }
+      right_sel_idx_ = 0;
+      if (!right_child_->NextBatch(&right_batch_)) {
+        right_exhausted_ = true;
+        if (partitions_.empty()) {
+          return false;
+        }
+        FinishPartitionedProbe();
+        if (!LoadNextSpilledPartition()) {
+          return false;
+        }
+        continue;
+      }
+    }
+    uint32_t row_idx = right_batch_.GetSelection()[right_sel_idx_++];
+    // Get the key by evaluating the right key expressions, a NULL key never joins
+    MakeKey(right_key_exprs_, right_batch_, row_idx, &right_hash_key);
+    if (right_hash_key.HasNull()) {
+      continue;
+    }
+    const HashJoinTable *table = &hash_table_;
+    if (!partitions_.empty()) {
+      HashJoinPartition &partition = partitions_[PartitionOf(right_hash_key, 0, partitions_.size())];
+      if (partition.build_run_ != nullptr) {
+        // The matching left tuples are spilled, so is the right tuple
+        partition.probe_run_->Append(right_batch_.MaterializeRow(row_idx));
+        continue;
+      }
+      table = &partition.table_;
+    }
+    // Check whether the key for this tuple exists in the hash table
+    left_match_table_ = table;
+    left_match_entry_ = table->Find(right_hash_key);
+    if (left_match_entry_ != HashJoinTable::NO_ENTRY) {
+      right_row_idx_ = row_idx;
+      if (needs_right_tuple_) {
+        right_tuple_ = right_batch_.MaterializeRow(row_idx);
+      }
+    }
+  }
+  return true;
+}
+
+void HashJoinExecutor::EvaluateOutputValues(const HashJoinTable &left_table, size_t left_entry,
+                                            const TupleBatch *right_batch, uint32_t right_row_idx,
+                                            const Tuple &right_tuple, Tuple *left_tuple,
+                                            std::vector<Value> *values) const {
+  const Schema *output_schema = plan_->OutputSchema();
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  if (needs_left_tuple_) {
+    left_table.GetTuple(left_entry, left_tuple);
+  }
+  for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+    if (left_columns_[col_idx] != nullptr) {
+      (*values)[col_idx] = left_table.GetValue(left_entry, left_schema, left_columns_[col_idx]->GetColIdx());
+    } else if (right_columns_[col_idx] != nullptr && right_batch != nullptr) {
+      (*values)[col_idx] = right_batch->GetValue(right_row_idx, right_columns_[col_idx]->GetColIdx());
+    } else {
+      (*values)[col_idx] = output_schema->GetColumn(col_idx).GetExpr()->EvaluateJoin(left_tuple, left_schema,
+                                                                                      &right_tuple, right_schema);
+    }
+  }
+}
+
+void HashJoinExecutor::ProbeMorsel(const TupleBatch &right_batch, std::vector<TupleBatch> *output) const {
+  HashJoinKey right_hash_key;
+  Tuple left_tuple;
+  Tuple right_tuple;
+  std::vector<Value> values(plan_->OutputSchema()->GetColumnCount());
+  output->emplace_back();
+  output->back().Reset(plan_->OutputSchema());
+  for (uint32_t row_idx : right_batch.GetSelection()) {
+    MakeKey(right_key_exprs_, right_batch, row_idx, &right_hash_key);
+    if (right_hash_key.HasNull()) {
+      continue;
+    }
+    const HashJoinTable &left_table = ResidentTable(right_hash_key);
+    size_t left_entry = left_table.Find(right_hash_key);
+    if (left_entry == HashJoinTable::NO_ENTRY) {
+      continue;
+    }
+    if (needs_right_tuple_) {
+      right_tuple = right_batch.MaterializeRow(row_idx);
+    }
+    for (; left_entry != HashJoinTable::NO_ENTRY; left_entry = left_table.NextEntry(left_entry)) {
+      if (output->back().IsFull()) {
+        output->emplace_back();
+        output->back().Reset(plan_->OutputSchema());
+      }
+      EvaluateOutputValues(left_table, left_entry, &right_batch, row_idx, right_tuple, &left_tuple, &values);
+      output->back().AppendValues(values, RID{});
+    }
+  }
+}
+
+bool HashJoinExecutor::GatherParallelProbe() {
+  while (gathered_batches_.empty()) {
+    if (right_exhausted_) {
+      return false;
+    }
+    // Pull one morsel per worker, the right child is only ever called from this thread
+    size_t num_morsels = 0;
+    while (num_morsels < degree_of_parallelism_ && right_child_->NextBatch(&probe_batches_[num_morsels])) {
+      num_morsels++;
+    }
+    right_exhausted_ = num_morsels < degree_of_parallelism_;
+    worker_pool_->Run(num_morsels,
+                      [this](size_t worker) { ProbeMorsel(probe_batches_[worker], &probe_outputs_[worker]); });
+    // Gather the results in morsel order
+    for (size_t worker = 0; worker < num_morsels; worker++) {
+      for (auto &output_batch : probe_outputs_[worker]) {
+        if (!output_batch.IsEmpty()) {
+          gathered_batches_.emplace_back(std::move(output_batch));
+        }
+      }
+      probe_outputs_[worker].clear();
+    }
+  }
+  return true;
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  if (parallel_probe_) {
+    if (!gathered_batches_.empty() && gathered_sel_idx_ == gathered_batches_.front().Size()) {
+      gathered_batches_.pop_front();
+      gathered_sel_idx_ = 0;
+    }
+    if (!GatherParallelProbe()) {
+      return false;
+    }
+    const TupleBatch &gathered_batch = gathered_batches_.front();
+    *tuple = gathered_batch.MaterializeRow(gathered_batch.GetSelection()[gathered_sel_idx_++]);
+    *rid = tuple->GetRid();
+    return true;
+  }
+  if (!AdvanceProbe()) {
+    // No more tuples
+    return false;
+  }
+  // Combine the next matching left tuple with the right row and produce a tuple as a join result
+  EvaluateOutputValues(*left_match_table_, left_match_entry_, spilled_probe_run_ == nullptr ? &right_batch_ : nullptr,
+                       right_row_idx_, right_tuple_, &left_tuple_, &output_values_);
+  left_match_entry_ = left_match_table_->NextEntry(left_match_entry_);
+  *tuple = Tuple(output_values_, GetOutputSchema());
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  if (parallel_probe_) {
+    if (!GatherParallelProbe()) {
+      batch->Reset(GetOutputSchema());
+      return false;
+    }
+    // Hand out the gathered batch as is
+    std::swap(*batch, gathered_batches_.front());
+    gathered_batches_.pop_front();
+    return true;
+  }
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && AdvanceProbe()) {
+    EvaluateOutputValues(*left_match_table_, left_match_entry_,
+                         spilled_probe_run_ == nullptr ? &right_batch_ : nullptr, right_row_idx_, right_tuple_,
+                         &left_tuple_, &output_values_);
+    left_match_entry_ = left_match_table_->NextEntry(left_match_entry_);
+    batch->AppendValues(output_values_, RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_nested_loop_join_executor.cpp
+//
+// Identification: src/execution/index_nested_loop_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/index_nested_loop_join_executor.h"
+
+#include "execution/expressions/column_value_expression.h"
+
+namespace bustub {
+
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                                         std::unique_ptr<AbstractExecutor> &&left_child,
+                                                         IndexInfo *index_info)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  scan_plan_ = dynamic_cast<const SeqScanPlanNode *>(plan_->GetRightPlan());
+  BUSTUB_ASSERT(scan_plan_ != nullptr, "The right plan of an index nested loop join must be a sequential scan.");
+  left_child_ = std::move(left_child);
+  index_info_ = index_info;
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(scan_plan_->GetTableOid());
+  scan_predicate_ = CompiledPredicate(scan_plan_->GetPredicate(), &table_info_->schema_);
+}
+
+IndexInfo *IndexNestedLoopJoinExecutor::FindInnerIndex(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan) {
+  const auto *scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan->GetRightPlan());
+  const auto *key_expr = dynamic_cast<const ColumnValueExpression *>(plan->RightJoinKeyExpression());
+  if (scan_plan == nullptr || key_expr == nullptr) {
+    return nullptr;
+  }
+  // The key is read from the scan output, the index is on a table column
+  const AbstractExpression *output_expr = scan_plan->OutputSchema()->GetColumn(key_expr->GetColIdx()).GetExpr();
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(output_expr);
+  if (column_expr == nullptr) {
+    return nullptr;
+  }
+  Catalog *catalog = exec_ctx->GetCatalog();
+  TableInfo *table_info = catalog->GetTable(scan_plan->GetTableOid());
+  for (IndexInfo *index_info : catalog->GetTableIndexes(table_info->name_)) {
+    const std::vector<uint32_t> &key_attrs = index_info->index_->GetKeyAttrs();
+    // The probe key is the serialized left key, so it must have the type of the indexed column
+    if (key_attrs.size() == 1 && key_attrs[0] == column_expr->GetColIdx() &&
+        table_info->schema_.GetColumn(key_attrs[0]).GetType() == plan->LeftJoinKeyExpression()->GetReturnType()) {
+      return index_info;
+    }
+  }
+  return nullptr;
+}
+
+void IndexNestedLoopJoinExecutor::Init() {
+  BUSTUB_ASSERT(left_child_ != nullptr, "Left child executor is null.");
+  BUSTUB_ASSERT(index_info_ != nullptr, "Index is null.");
+  left_child_->Init();
+  left_batch_.Reset(left_child_->GetOutputSchema());
+  left_sel_idx_ = 0;
+  left_exhausted_ = false;
+  matches_ = nullptr;
+  match_idx_ = 0;
+  probe_cache_.clear();
+}
+
+const std::vector<Tuple> &IndexNestedLoopJoinExecutor::Probe(const Value &key_value) {
+  probe_key_.Clear();
+  probe_key_.Append(key_value);
+  auto [cache_iter, inserted] = probe_cache_.try_emplace(probe_key_);
+  std::vector<Tuple> &right_tuples = cache_iter->second;
+  if (!inserted) {
+    return right_tuples;
+  }
+  Transaction *txn = exec_ctx_->GetTransaction();
+  LockManager *lock_mgr = exec_ctx_->GetLockManager();
+  std::vector<RID> rids;
+  index_info_->index_->ScanKey(Tuple({key_value}, &index_info_->key_schema_), &rids, txn);
+  const Schema *output_schema = scan_plan_->OutputSchema();
+  std::vector<Value> vals(output_schema->GetColumnCount());
+  Tuple table_tuple;
+  for (const RID &rid : rids) {
+    // Lock the row like the scan would, the index entry may be gone from the table
+    lock_mgr->LockShared(txn, rid);
+    // Like the scan, the predicate is evaluated on the table tuple and only qualifying rows are projected
+    bool qualifies = table_info_->table_->GetTuple(rid, &table_tuple, txn) && scan_predicate_.Evaluate(&table_tuple);
+    if (qualifies) {
+      for (size_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+        vals[col_idx] = output_schema->GetColumn(col_idx).GetExpr()->Evaluate(&table_tuple, &table_info_->schema_);
+      }
+    }
+    if (txn->GetIsolationLevel() != IsolationLevel::REPEATABLE_READ) {
+      lock_mgr->Unlock(txn, rid);
+    }
+    if (qualifies) {
+      right_tuples.emplace_back(vals, output_schema);
+    }
+  }
+  return right_tuples;
+}
+
+const Tuple *IndexNestedLoopJoinExecutor::NextMatch() {
+  while (true) {
+    if (matches_ != nullptr && match_idx_ < matches_->size()) {
+      return &(*matches_)[match_idx_++];
+    }
+    matches_ = nullptr;
+    match_idx_ = 0;
+    if (left_exhausted_) {
+      return nullptr;
+    }
+    if (left_sel_idx_ == left_batch_.Size()) {
+      if (!left_child_->NextBatch(&left_batch_)) {
+        left_exhausted_ = true;
+        return nullptr;
+      }
+      // The right tuples of the previous batch are not needed anymore
+      left_sel_idx_ = 0;
+      probe_cache_.clear();
+    }
+    uint32_t row_idx = left_batch_.GetSelection()[left_sel_idx_++];
+    Value key_value = left_batch_.EvaluateAt(plan_->LeftJoinKeyExpression(), row_idx);
+    if (key_value.IsNull()) {
+      continue;
+    }
+    matches_ = &Probe(key_value);
+    if (!matches_->empty()) {
+      left_tuple_ = left_batch_.MaterializeRow(row_idx);
+    }
+  }
+}
+
+void IndexNestedLoopJoinExecutor::EvaluateOutputValues(const Tuple &right_tuple, std::vector<Value> *values) {
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *right_schema = scan_plan_->OutputSchema();
+  values->clear();
+  for (auto &col : GetOutputSchema()->GetColumns()) {
+    values->emplace_back(col.GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema));
+  }
+}
+
+bool IndexNestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Tuple *right_tuple = NextMatch();
+  if (right_tuple == nullptr) {
+    return false;
+  }
+  EvaluateOutputValues(*right_tuple, &output_values_);
+  *tuple = Tuple(output_values_, GetOutputSchema());
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool IndexNestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  const Tuple *right_tuple;
+  while (!batch->IsFull() && (right_tuple = NextMatch()) != nullptr) {
+    EvaluateOutputValues(*right_tuple, &output_values_);
+    batch->AppendValues(output_values_, RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
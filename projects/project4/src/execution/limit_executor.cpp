@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// limit_executor.cpp
+//
+// Identification: src/execution/limit_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "execution/executors/limit_executor.h"
+
+namespace bustub {
+
+LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
+                             std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  child_executor_ = std::move(child_executor);
+  num_tuples_remain_ = plan->GetLimit();
+}
+
+void LimitExecutor::Init() {
+  BUSTUB_ASSERT(child_executor_ != nullptr, "The child executor is a nullptr.");
+  child_executor_->Init();
+}
+
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
+  if (num_tuples_remain_ == 0) {
+    return false;
+  }
+  if (child_executor_->Next(tuple, rid)) {
+    num_tuples_remain_--;
+    return true;
+  }
+  // If a tuple is not produced, it can be
+  // the case that a child node is unable to produce
+  // a new tuple at the moment, do not decrement the counter
+  return false;
+}
+
+bool LimitExecutor::NextBatch(TupleBatch *batch) {
+  if (num_tuples_remain_ == 0) {
+    batch->Reset(GetOutputSchema());
+    return false;
+  }
+  // Only ask the child for the remaining rows, so it does not lock and project rows past the limit
+  uint32_t capacity = batch->GetCapacity();
+  batch->SetCapacity(static_cast<uint32_t>(std::min<size_t>(num_tuples_remain_, capacity)));
+  bool has_rows = child_executor_->NextBatch(batch);
+  batch->SetCapacity(capacity);
+  if (!has_rows) {
+    return false;
+  }
+  // A child that hands out batches it filled beforehand, like an exchange, may still produce more rows
+  batch->Truncate(static_cast<uint32_t>(std::min<size_t>(num_tuples_remain_, batch->Size())));
+  num_tuples_remain_ -= batch->Size();
+  return true;
+}
+
+}  // namespace bustub
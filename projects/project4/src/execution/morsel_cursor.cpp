@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_cursor.cpp
+//
+// Identification: src/execution/morsel_cursor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_cursor.h"
+
+#include "common/exception.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+bool MorselCursor::NextMorsel(std::vector<page_id_t> *page_ids) {
+  page_ids->clear();
+  std::scoped_lock latch(latch_);
+  while (page_ids->size() < MORSEL_SIZE && next_page_id_ != INVALID_PAGE_ID) {
+    auto *page = reinterpret_cast<TablePage *>(bpm_->FetchPage(next_page_id_));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a table page for a morsel.");
+    }
+    page_ids->emplace_back(next_page_id_);
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    bpm_->UnpinPage(page_ids->back(), false);
+    next_page_id_ = next_page_id;
+  }
+  return !page_ids->empty();
+}
+
+}  // namespace bustub
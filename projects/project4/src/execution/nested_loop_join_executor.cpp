@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_join_executor.cpp
+//
+// Identification: src/execution/nested_loop_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/nested_loop_join_executor.h"
+
+namespace bustub {
+
+NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
+                                               std::unique_ptr<AbstractExecutor> &&left_executor,
+                                               std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  left_executor_ = std::move(left_executor);
+  right_executor_ = std::move(right_executor);
+}
+
+void NestedLoopJoinExecutor::Init() {
+  // Init the left and right child executors
+  BUSTUB_ASSERT(left_executor_ != nullptr, "Left child executor is null.");
+  BUSTUB_ASSERT(right_executor_ != nullptr, "Right child executor is null.");
+  left_executor_->Init();
+  predicate_ = CompiledPredicate(plan_->Predicate(), left_executor_->GetOutputSchema(),
+                                 right_executor_->GetOutputSchema());
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  // Keep half of the budget for the right cache until it is known whether the right side fits into it
+  block_budget_ = memory_budget_ / 2;
+  left_exhausted_ = false;
+  inner_cache_.clear();
+  inner_cache_bytes_ = 0;
+  inner_cached_ = false;
+  LoadOuterBlock();
+  // The right side is scanned only once if the left side fits into a single block, there is nothing to cache
+  filling_inner_cache_ = !left_exhausted_;
+}
+
+bool NestedLoopJoinExecutor::LoadOuterBlock() {
+  outer_block_.clear();
+  outer_idx_ = 0;
+  inner_tuple_ = nullptr;
+  size_t block_bytes = 0;
+  Tuple left_tuple;
+  RID left_rid;
+  // A block holds at least one left tuple, however small the budget is
+  while (!left_exhausted_ && (outer_block_.empty() || block_bytes < block_budget_)) {
+    if (!left_executor_->Next(&left_tuple, &left_rid)) {
+      left_exhausted_ = true;
+      break;
+    }
+    block_bytes += TupleMemoryUsage(left_tuple);
+    outer_block_.emplace_back(std::move(left_tuple));
+  }
+  if (outer_block_.empty()) {
+    return false;
+  }
+  // Rewind the right side for the new block
+  if (inner_cached_) {
+    inner_cache_idx_ = 0;
+  } else {
+    right_executor_->Init();
+  }
+  return true;
+}
+
+bool NestedLoopJoinExecutor::NextInnerTuple() {
+  if (inner_cached_) {
+    if (inner_cache_idx_ == inner_cache_.size()) {
+      return false;
+    }
+    inner_tuple_ = &inner_cache_[inner_cache_idx_++];
+    return true;
+  }
+  RID right_rid;
+  if (!right_executor_->Next(&inner_scan_tuple_, &right_rid)) {
+    // The first scan is over, the later blocks get all of the budget the right side does not take
+    inner_cached_ = filling_inner_cache_;
+    filling_inner_cache_ = false;
+    block_budget_ = memory_budget_ - inner_cache_bytes_;
+    return false;
+  }
+  if (filling_inner_cache_) {
+    inner_cache_bytes_ += TupleMemoryUsage(inner_scan_tuple_);
+    if (inner_cache_bytes_ <= memory_budget_ / 2) {
+      inner_cache_.emplace_back(inner_scan_tuple_);
+    } else {
+      // The right side is too large to be cached, it is scanned once per block
+      filling_inner_cache_ = false;
+      inner_cache_.clear();
+      inner_cache_.shrink_to_fit();
+      inner_cache_bytes_ = 0;
+    }
+  }
+  inner_tuple_ = &inner_scan_tuple_;
+  return true;
+}
+
+const Tuple *NestedLoopJoinExecutor::NextMatch() {
+  while (!outer_block_.empty()) {
+    if (inner_tuple_ != nullptr) {
+      // Join the current right tuple with the rest of the block
+      // If the predicate is nullptr, meaning that it is a full join, produce all combinations
+      while (outer_idx_ < outer_block_.size()) {
+        const Tuple &left_tuple = outer_block_[outer_idx_++];
+        if (predicate_.EvaluateJoin(&left_tuple, inner_tuple_)) {
+          return &left_tuple;
+        }
+      }
+    }
+    outer_idx_ = 0;
+    if (!NextInnerTuple()) {
+      // The block has been joined with the whole right side, move on to the next one
+      LoadOuterBlock();
+    }
+  }
+  return nullptr;
+}
+
+void NestedLoopJoinExecutor::EvaluateOutputValues(const Tuple &left_tuple, std::vector<Value> *values) {
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  values->clear();
+  for (auto &col : GetOutputSchema()->GetColumns()) {
+    values->emplace_back(col.GetExpr()->EvaluateJoin(&left_tuple, left_schema, inner_tuple_, right_schema));
+  }
+}
+
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Tuple *left_tuple = NextMatch();
+  if (left_tuple == nullptr) {
+    // There is no more tuples
+    return false;
+  }
+  EvaluateOutputValues(*left_tuple, &output_values_);
+  *tuple = Tuple(output_values_, GetOutputSchema());
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  const Tuple *left_tuple;
+  while (!batch->IsFull() && (left_tuple = NextMatch()) != nullptr) {
+    EvaluateOutputValues(*left_tuple, &output_values_);
+    batch->AppendValues(output_values_, RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
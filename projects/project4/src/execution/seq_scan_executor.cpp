@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())),
+      table_itr_(table_info_->table_->Begin(exec_ctx_->GetTransaction())) {
+  predicate_ = CompiledPredicate(plan_->GetPredicate(), &table_info_->schema_);
+}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, MorselCursor *cursor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      table_info_(exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())),
+      table_itr_(table_info_->table_->End()),
+      cursor_(cursor) {
+  predicate_ = CompiledPredicate(plan_->GetPredicate(), &table_info_->schema_);
+}
+
+void SeqScanExecutor::Init() {
+  if (cursor_ != nullptr) {
+    // The morsels are taken on demand, the cursor is reset by the owner of the parallel scan
+    table_itr_ = table_info_->table_->End();
+    morsel_page_ids_.clear();
+    morsel_page_id_ = INVALID_PAGE_ID;
+    return;
+  }
+  // ** Very important step, this will be used in the nested loop join !!!
+  table_itr_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
+}
+
+bool SeqScanExecutor::HasRow() {
+  if (cursor_ == nullptr) {
+    return table_itr_ != table_info_->table_->End();
+  }
+  while (true) {
+    // The iterator follows the page chain, it leaves the morsel at the first row of a page of another scan
+    page_id_t page_id = table_itr_->GetRid().GetPageId();
+    if (page_id != INVALID_PAGE_ID &&
+        (page_id == morsel_page_id_ ||
+         std::find(morsel_page_ids_.begin(), morsel_page_ids_.end(), page_id) != morsel_page_ids_.end())) {
+      morsel_page_id_ = page_id;
+      return true;
+    }
+    if (!NextMorsel()) {
+      return false;
+    }
+  }
+}
+
+bool SeqScanExecutor::NextMorsel() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  while (cursor_->NextMorsel(&morsel_page_ids_)) {
+    for (page_id_t page_id : morsel_page_ids_) {
+      auto *page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a table page of a morsel.");
+      }
+      RID first_rid;
+      page->RLatch();
+      bool found = page->GetFirstTupleRid(&first_rid);
+      page->RUnlatch();
+      bpm->UnpinPage(page_id, false);
+      if (found) {
+        table_itr_ = TableIterator(table_info_->table_.get(), first_rid, exec_ctx_->GetTransaction());
+        morsel_page_id_ = page_id;
+        return true;
+      }
+    }
+  }
+  morsel_page_ids_.clear();
+  morsel_page_id_ = INVALID_PAGE_ID;
+  table_itr_ = table_info_->table_->End();
+  return false;
+}
+
+bool SeqScanExecutor::SetRuntimeFilter(const RuntimeFilter *filter) {
+  runtime_filter_ = nullptr;
+  filter_key_exprs_.clear();
+  if (filter == nullptr) {
+    return true;
+  }
+  // Read every key from the table tuple through the expression of the output column it refers to
+  for (const auto *key_expr : filter->GetKeyExpressions()) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(key_expr);
+    if (column_expr == nullptr) {
+      filter_key_exprs_.clear();
+      return false;
+    }
+    filter_key_exprs_.emplace_back(GetOutputSchema()->GetColumn(column_expr->GetColIdx()).GetExpr());
+  }
+  runtime_filter_ = filter;
+  return true;
+}
+
+bool SeqScanExecutor::PassesRuntimeFilter(const Tuple &table_tuple) {
+  if (runtime_filter_ == nullptr) {
+    return true;
+  }
+  filter_key_.Clear();
+  for (const auto *key_expr : filter_key_exprs_) {
+    filter_key_.Append(key_expr->Evaluate(&table_tuple, &table_info_->schema_));
+  }
+  return runtime_filter_->MayContain(filter_key_);
+}
+
+bool SeqScanExecutor::Qualifies(const Tuple &table_tuple) {
+  return predicate_.Evaluate(&table_tuple) && PassesRuntimeFilter(table_tuple);
+}
+
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
+  BUSTUB_ASSERT(table_info_ != nullptr, "Either the table info or iterator is nullptr.");
+  const Schema *output_schema = GetOutputSchema();
+  const Schema &schema = table_info_->schema_;
+  LockManager *lock_mgr = GetExecutorContext()->GetLockManager();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  output_values_.resize(output_schema->GetColumnCount());
+  // Skip the rows that do not qualify before locking them or evaluating their output columns
+  for (; HasRow(); table_itr_++) {
+    const Tuple &table_tuple = *table_itr_;
+    if (!Qualifies(table_tuple)) {
+      continue;
+    }
+    RID row_rid = table_tuple.GetRid();
+    lock_mgr->LockShared(txn, row_rid);
+    for (size_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+      output_values_[col_idx] = output_schema->GetColumn(col_idx).GetExpr()->Evaluate(&table_tuple, &schema);
+    }
+    if (txn->GetIsolationLevel() != IsolationLevel::REPEATABLE_READ) {
+      lock_mgr->Unlock(txn, row_rid);
+    }
+    *tuple = Tuple(output_values_, output_schema);
+    *rid = row_rid;
+    table_itr_++;
+    return true;
+  }
+  return false;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  BUSTUB_ASSERT(table_info_ != nullptr, "Either the table info or iterator is nullptr.");
+  const Schema *output_schema = GetOutputSchema();
+  const Schema &schema = table_info_->schema_;
+  LockManager *lock_mgr = GetExecutorContext()->GetLockManager();
+  Transaction *txn = GetExecutorContext()->GetTransaction();
+  // The row buffer is reused for every row, the values are copied into the batch columns
+  output_values_.resize(output_schema->GetColumnCount());
+  batch->Reset(output_schema);
+  // Only the qualifying rows are locked, projected and appended, so a batch is only cut short by the end of the table
+  for (; !batch->IsFull() && HasRow(); table_itr_++) {
+    const Tuple &table_tuple = *table_itr_;
+    if (!Qualifies(table_tuple)) {
+      continue;
+    }
+    RID row_rid = table_tuple.GetRid();
+    lock_mgr->LockShared(txn, row_rid);
+    for (size_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+      output_values_[col_idx] = output_schema->GetColumn(col_idx).GetExpr()->Evaluate(&table_tuple, &schema);
+    }
+    batch->AppendValues(output_values_, row_rid);
+    if (txn->GetIsolationLevel() != IsolationLevel::REPEATABLE_READ) {
+      lock_mgr->Unlock(txn, row_rid);
+    }
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
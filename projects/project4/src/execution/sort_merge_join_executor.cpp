@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.cpp
+//
+// Identification: src/execution/sort_merge_join_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_merge_join_executor.h"
+
+namespace bustub {
+
+SortMergeJoinExecutor::SortMergeJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                             std::unique_ptr<AbstractExecutor> &&left_child,
+                                             std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  left_child_ = std::move(left_child);
+  right_child_ = std::move(right_child);
+}
+
+void SortMergeJoinExecutor::Init() {
+  BUSTUB_ASSERT(left_child_ != nullptr, "Left child executor is null.");
+  BUSTUB_ASSERT(right_child_ != nullptr, "Right child executor is null.");
+  left_child_->Init();
+  right_child_->Init();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  in_group_ = false;
+  group_.clear();
+  group_run_.reset();
+  AdvanceLeft();
+  AdvanceRight();
+}
+
+void SortMergeJoinExecutor::AdvanceLeft() {
+  RID rid;
+  while ((left_valid_ = left_child_->Next(&left_tuple_, &rid))) {
+    MakeKey(plan_->LeftJoinKeyExpression(), left_tuple_, left_child_->GetOutputSchema(), &left_key_);
+    if (!left_key_.HasNull()) {
+      return;
+    }
+  }
+}
+
+void SortMergeJoinExecutor::AdvanceRight() {
+  RID rid;
+  while ((right_valid_ = right_child_->Next(&right_tuple_, &rid))) {
+    MakeKey(plan_->RightJoinKeyExpression(), right_tuple_, right_child_->GetOutputSchema(), &right_key_);
+    if (!right_key_.HasNull()) {
+      return;
+    }
+  }
+}
+
+void SortMergeJoinExecutor::LoadGroup() {
+  group_.clear();
+  group_bytes_ = 0;
+  group_run_.reset();
+  group_key_ = right_key_;
+  while (right_valid_ && right_key_ == group_key_) {
+    size_t tuple_bytes = sizeof(Tuple) + right_tuple_.GetLength();
+    if (group_run_ == nullptr && group_bytes_ + tuple_bytes <= memory_budget_) {
+      group_.emplace_back(right_tuple_);
+      group_bytes_ += tuple_bytes;
+    } else {
+      // The group does not fit into memory, its remaining tuples go to temporary pages
+      if (group_run_ == nullptr) {
+        group_run_ = std::make_unique<TmpTupleRun>(exec_ctx_->GetBufferPoolManager());
+      }
+      group_run_->Append(right_tuple_);
+    }
+    AdvanceRight();
+  }
+  if (group_run_ != nullptr) {
+    group_run_->FinishWrite();
+  }
+}
+
+void SortMergeJoinExecutor::RewindGroup() {
+  group_idx_ = 0;
+  if (group_run_ != nullptr) {
+    group_run_->BeginRead();
+  }
+}
+
+const Tuple *SortMergeJoinExecutor::NextMatch() {
+  while (left_valid_) {
+    if (in_group_) {
+      if (group_idx_ < group_.size()) {
+        return &group_[group_idx_++];
+      }
+      if (group_run_ != nullptr && group_run_->Next(&group_run_tuple_)) {
+        return &group_run_tuple_;
+      }
+      // The left tuple has been joined with the whole group, the next one may have the same key
+      AdvanceLeft();
+      in_group_ = left_valid_ && left_key_ == group_key_;
+      if (in_group_) {
+        RewindGroup();
+      }
+      continue;
+    }
+    if (!right_valid_) {
+      // No right tuple is left to match the remaining left tuples
+      return nullptr;
+    }
+    int cmp = left_key_.Compare(right_key_);
+    if (cmp < 0) {
+      AdvanceLeft();
+    } else if (cmp > 0) {
+      AdvanceRight();
+    } else {
+      LoadGroup();
+      RewindGroup();
+      in_group_ = true;
+    }
+  }
+  return nullptr;
+}
+
+void SortMergeJoinExecutor::EvaluateOutputValues(const Tuple &right_tuple, std::vector<Value> *values) {
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  values->clear();
+  for (auto &col : GetOutputSchema()->GetColumns()) {
+    values->emplace_back(col.GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema));
+  }
+}
+
+bool SortMergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Tuple *right_tuple = NextMatch();
+  if (right_tuple == nullptr) {
+    return false;
+  }
+  EvaluateOutputValues(*right_tuple, &output_values_);
+  *tuple = Tuple(output_values_, GetOutputSchema());
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool SortMergeJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  const Tuple *right_tuple;
+  while (!batch->IsFull() && (right_tuple = NextMatch()) != nullptr) {
+    EvaluateOutputValues(*right_tuple, &output_values_);
+    batch->AppendValues(output_values_, RID{});
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.cpp
+//
+// Identification: src/execution/tmp_tuple_run.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tmp_tuple_run.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleRun::~TmpTupleRun() {
+  FinishWrite();
+  ReleaseReadPage();
+  for (page_id_t page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleRun::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (write_page_ != nullptr && write_page_->Insert(tuple, &tmp_tuple)) {
+    num_tuples_++;
+    num_bytes_ += tuple.GetLength();
+    return;
+  }
+  // The current page is full, continue on a fresh one
+  FinishWrite();
+  page_id_t page_id;
+  write_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (write_page_ == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "TmpTupleRun: no free frame for a temporary page.");
+  }
+  write_page_->Init(page_id, PAGE_SIZE);
+  page_ids_.emplace_back(page_id);
+  bool inserted = write_page_->Insert(tuple, &tmp_tuple);
+  BUSTUB_ASSERT(inserted, "The tuple does not fit into a temporary page.");
+  num_tuples_++;
+  num_bytes_ += tuple.GetLength();
+}
+
+void TmpTupleRun::FinishWrite() {
+  if (write_page_ != nullptr) {
+    bpm_->UnpinPage(write_page_->GetTablePageId(), true);
+    write_page_ = nullptr;
+  }
+}
+
+void TmpTupleRun::BeginRead() {
+  BUSTUB_ASSERT(write_page_ == nullptr, "The run is still being written.");
+  ReleaseReadPage();
+  read_page_idx_ = 0;
+  LoadReadPage();
+}
+
+bool TmpTupleRun::Next(Tuple *tuple) {
+  while (read_offsets_.empty()) {
+    if (read_page_ == nullptr) {
+      return false;
+    }
+    ReleaseReadPage();
+    read_page_idx_++;
+    LoadReadPage();
+  }
+  read_page_->Get(read_offsets_.back(), tuple);
+  read_offsets_.pop_back();
+  return true;
+}
+
+void TmpTupleRun::LoadReadPage() {
+  read_offsets_.clear();
+  if (read_page_idx_ == page_ids_.size()) {
+    return;
+  }
+  read_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_ids_[read_page_idx_]));
+  if (read_page_ == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "TmpTupleRun: no free frame for a temporary page.");
+  }
+  // Tuples are stored from the end of the page towards its header, the latest one first
+  for (uint32_t offset = read_page_->GetFreeSpacePointer(); offset < PAGE_SIZE;
+       offset = read_page_->GetNextOffset(offset)) {
+    read_offsets_.emplace_back(offset);
+  }
+}
+
+void TmpTupleRun::ReleaseReadPage() {
+  if (read_page_ != nullptr) {
+    bpm_->UnpinPage(read_page_->GetTablePageId(), false);
+    read_page_ = nullptr;
+  }
+  read_offsets_.clear();
+}
+
+}  // namespace bustub
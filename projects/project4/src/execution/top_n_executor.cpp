@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.cpp
+//
+// Identification: src/execution/top_n_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/top_n_executor.h"
+
+#include <algorithm>
+
+#include "execution/executors/external_sort_executor.h"
+#include "execution/executors/limit_executor.h"
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor,
+                           std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys)
+    : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  child_executor_ = std::move(child_executor);
+  order_bys_ = std::move(order_bys);
+}
+
+std::unique_ptr<AbstractExecutor> TopNExecutor::CreateLimit(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
+                                                            std::unique_ptr<AbstractExecutor> &&child_executor) {
+  auto *sort_executor = dynamic_cast<ExternalSortExecutor *>(child_executor.get());
+  if (sort_executor == nullptr) {
+    return std::make_unique<LimitExecutor>(exec_ctx, plan, std::move(child_executor));
+  }
+  // The sort is replaced, its child feeds the top-N directly
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys = sort_executor->GetOrderBys();
+  return std::make_unique<TopNExecutor>(exec_ctx, plan, sort_executor->ReleaseChildExecutor(), std::move(order_bys));
+}
+
+void TopNExecutor::Init() {
+  BUSTUB_ASSERT(child_executor_ != nullptr, "The child executor is a nullptr.");
+  child_executor_->Init();
+  entries_.clear();
+  entry_idx_ = 0;
+  num_seen_ = 0;
+  if (plan_->GetLimit() == 0) {
+    return;
+  }
+  // The limit may be far above the number of child rows, so at most a batch worth of entries is reserved up front
+  entries_.reserve(std::min<size_t>(plan_->GetLimit(), TupleBatch::BATCH_SIZE));
+  TupleBatch batch;
+  while (child_executor_->NextBatch(&batch)) {
+    for (uint32_t row_idx : batch.GetSelection()) {
+      Offer(batch, row_idx);
+    }
+  }
+  std::sort_heap(entries_.begin(), entries_.end(), EntryLess);
+}
+
+void TopNExecutor::Offer(const TupleBatch &batch, uint32_t row_idx) {
+  key_.Clear();
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    key_.Append(batch.EvaluateAt(expr, row_idx), order_by_type);
+  }
+  size_t seq = num_seen_++;
+  if (entries_.size() < plan_->GetLimit()) {
+    entries_.emplace_back(TopNEntry{key_, seq, batch.MaterializeRow(row_idx)});
+    std::push_heap(entries_.begin(), entries_.end(), EntryLess);
+    return;
+  }
+  // A later row only beats the worst kept one with a strictly smaller key
+  if (!(key_ < entries_.front().key_)) {
+    return;
+  }
+  std::pop_heap(entries_.begin(), entries_.end(), EntryLess);
+  TopNEntry &entry = entries_.back();
+  std::swap(entry.key_, key_);
+  entry.seq_ = seq;
+  entry.tuple_ = batch.MaterializeRow(row_idx);
+  std::push_heap(entries_.begin(), entries_.end(), EntryLess);
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (entry_idx_ == entries_.size()) {
+    return false;
+  }
+  *tuple = std::move(entries_[entry_idx_++].tuple_);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool TopNExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && entry_idx_ < entries_.size()) {
+    const Tuple &tuple = entries_[entry_idx_++].tuple_;
+    batch->AppendTuple(tuple, tuple.GetRid());
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(const Schema *schema) {
+  schema_ = schema;
+  uint32_t column_count = schema_ == nullptr ? 0 : schema_->GetColumnCount();
+  // Keep the column vectors of the previous batch around, so their storage is reused
+  columns_.resize(column_count);
+  for (auto &column : columns_) {
+    column.clear();
+    column.reserve(BATCH_SIZE);
+  }
+  rids_.clear();
+  rids_.reserve(BATCH_SIZE);
+  selection_.clear();
+  selection_.reserve(BATCH_SIZE);
+}
+
+void TupleBatch::AppendValues(const std::vector<Value> &values, const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "The batch is full.");
+  BUSTUB_ASSERT(values.size() == columns_.size(), "The row does not match the batch schema.");
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].emplace_back(values[col_idx]);
+  }
+  selection_.emplace_back(NumRows());
+  rids_.emplace_back(rid);
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "The batch is full.");
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].emplace_back(tuple.GetValue(schema_, col_idx));
+  }
+  selection_.emplace_back(NumRows());
+  rids_.emplace_back(rid);
+}
+
+void TupleBatch::Truncate(uint32_t size) {
+  if (size < Size()) {
+    selection_.resize(size);
+  }
+}
+
+Value TupleBatch::EvaluateAt(const AbstractExpression *expr, uint32_t row_idx) const {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr); column_expr != nullptr) {
+    return columns_[column_expr->GetColIdx()][row_idx];
+  }
+  if (dynamic_cast<const ConstantValueExpression *>(expr) != nullptr) {
+    // A constant does not look at the tuple
+    return expr->Evaluate(nullptr, schema_);
+  }
+  if (const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr); comparison_expr != nullptr) {
+    Value lhs = EvaluateAt(comparison_expr->GetChildAt(0), row_idx);
+    Value rhs = EvaluateAt(comparison_expr->GetChildAt(1), row_idx);
+    return ValueFactory::GetBooleanValue(comparison_expr->PerformComparison(lhs, rhs));
+  }
+  Tuple tuple = MaterializeRow(row_idx);
+  return expr->Evaluate(&tuple, schema_);
+}
+
+Tuple TupleBatch::MaterializeRow(uint32_t row_idx) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.emplace_back(column[row_idx]);
+  }
+  return Tuple(values, schema_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.cpp
+//
+// Identification: src/execution/worker_pool.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/worker_pool.h"
+
+namespace bustub {
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  BUSTUB_ASSERT(num_threads > 0, "A worker pool needs at least one thread.");
+  threads_.reserve(num_threads - 1);
+  for (size_t thread_idx = 1; thread_idx < num_threads; thread_idx++) {
+    threads_.emplace_back(&WorkerPool::RunWorker, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock latch(latch_);
+    stopping_ = true;
+  }
+  has_tasks_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(size_t num_tasks, const std::function<void(size_t)> &task) {
+  std::unique_lock<std::mutex> latch(latch_);
+  task_ = &task;
+  num_tasks_ = num_tasks;
+  next_task_ = 0;
+  num_unfinished_ = num_tasks;
+  error_ = nullptr;
+  has_tasks_.notify_all();
+  RunTasks(&latch);
+  tasks_done_.wait(latch, [&] { return num_unfinished_ == 0; });
+  task_ = nullptr;
+  num_tasks_ = 0;
+  next_task_ = 0;
+  std::exception_ptr error = error_;
+  error_ = nullptr;
+  latch.unlock();
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkerPool::RunWorker() {
+  std::unique_lock<std::mutex> latch(latch_);
+  while (true) {
+    has_tasks_.wait(latch, [&] { return stopping_ || next_task_ < num_tasks_; });
+    if (stopping_) {
+      return;
+    }
+    RunTasks(&latch);
+  }
+}
+
+void WorkerPool::RunTasks(std::unique_lock<std::mutex> *latch) {
+  while (next_task_ < num_tasks_) {
+    size_t task_idx = next_task_++;
+    const std::function<void(size_t)> &task = *task_;
+    latch->unlock();
+    std::exception_ptr error;
+    try {
+      task(task_idx);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    latch->lock();
+    if (error != nullptr && error_ == nullptr) {
+      error_ = error;
+    }
+    if (--num_unfinished_ == 0) {
+      tasks_done_.notify_all();
+    }
+  }
+}
+
+}  // namespace bustub
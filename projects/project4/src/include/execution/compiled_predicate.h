@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.h
+//
+// Identification: src/include/execution/compiled_predicate.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * CompiledPredicate is a predicate lowered, once per executor, into a function specialized for the types of its
+ * operands, that reads them straight from the bytes of the tuples.
+ *
+ * A comparison of two integer columns, or of an integer column and an integer constant, becomes an instance of
+ * Compare() for the two column types and the comparison type: it loads the raw integers at offsets resolved against
+ * the schemas, without a virtual call nor a Value. A row with a NULL operand, and any other predicate, goes through
+ * the expression tree as before, so the results are always those of the interpreted predicate.
+ */
+class CompiledPredicate {
+ public:
+  /** An empty predicate, which every tuple satisfies */
+  CompiledPredicate() = default;
+
+  /**
+   * Lower a predicate evaluated on the tuples of a schema, as AbstractExpression::Evaluate() does.
+   * @param predicate the predicate, nullptr if every tuple satisfies it
+   * @param schema the schema of the tuples
+   */
+  CompiledPredicate(const AbstractExpression *predicate, const Schema *schema);
+
+  /**
+   * Lower a join predicate evaluated on pairs of tuples, as AbstractExpression::EvaluateJoin() does.
+   * @param predicate the predicate, nullptr if every pair satisfies it
+   * @param left_schema the schema of the left tuples
+   * @param right_schema the schema of the right tuples
+   */
+  CompiledPredicate(const AbstractExpression *predicate, const Schema *left_schema, const Schema *right_schema);
+
+  /** @return `true` if the predicate runs as a specialized function rather than through the expression tree */
+  bool IsCompiled() const { return compare_ != nullptr; }
+
+  /**
+   * Evaluate a predicate lowered for a single schema.
+   * @param tuple the tuple
+   * @return `true` if the tuple satisfies the predicate
+   */
+  bool Evaluate(const Tuple *tuple) const {
+    if (compare_ != nullptr) {
+      return compare_(*this, tuple, tuple);
+    }
+    return predicate_ == nullptr || Interpret(tuple, tuple);
+  }
+
+  /**
+   * Evaluate a predicate lowered for a join.
+   * @param left_tuple the left tuple
+   * @param right_tuple the right tuple
+   * @return `true` if the pair satisfies the predicate
+   */
+  bool EvaluateJoin(const Tuple *left_tuple, const Tuple *right_tuple) const {
+    if (compare_ != nullptr) {
+      return compare_(*this, left_tuple, right_tuple);
+    }
+    return predicate_ == nullptr || Interpret(left_tuple, right_tuple);
+  }
+
+ private:
+  /** The right operand of a comparison with a constant */
+  struct ConstantOperand {};
+
+  /** A column operand, resolved to the bytes of a tuple */
+  struct ColumnOperand {
+    /** 0 for the left tuple, 1 for the right one */
+    uint32_t tuple_idx_{0};
+    /** The offset of the column in the tuple */
+    uint32_t offset_{0};
+  };
+
+  /** The function a comparison is lowered into */
+  using CompareFunction = bool (*)(const CompiledPredicate &, const Tuple *, const Tuple *);
+
+  /** Lower a comparison of two integer operands, leaving compare_ null if its shape is not supported */
+  void Lower(const AbstractExpression *predicate);
+
+  /**
+   * Resolve a column operand.
+   * @param expr the operand expression
+   * @param[out] operand the column
+   * @param[out] type the type of the column
+   * @return `false` if the operand is not a column with an integer type
+   */
+  bool ResolveColumn(const AbstractExpression *expr, ColumnOperand *operand, TypeId *type) const;
+
+  /**
+   * Resolve a constant operand.
+   * @param expr the operand expression
+   * @return `false` if the operand is not a constant of an integer type, or is NULL
+   */
+  bool ResolveConstant(const AbstractExpression *expr);
+
+  /** @return the comparison of a left column of type L with a right operand R, for a comparison type */
+  template <typename L, typename R>
+  static CompareFunction PickComparison(ComparisonType comp_type);
+
+  /** @return the comparison of a left column of type L with a right column of some type */
+  template <typename L>
+  static CompareFunction PickRightType(TypeId right_type, ComparisonType comp_type);
+
+  /**
+   * Compare a left column of type L with a right operand R, a column of that type or the constant.
+   * @return the comparison, or the interpreted predicate if some operand is NULL
+   */
+  template <typename L, typename R, ComparisonType CMP>
+  static bool Compare(const CompiledPredicate &pred, const Tuple *left_tuple, const Tuple *right_tuple);
+
+  /** @return the raw value of a column operand of type T */
+  template <typename T>
+  static T ReadColumn(const ColumnOperand &operand, const Tuple *left_tuple, const Tuple *right_tuple) {
+    const Tuple *tuple = operand.tuple_idx_ == 0 ? left_tuple : right_tuple;
+    T raw;
+    memcpy(&raw, tuple->GetData() + operand.offset_, sizeof(T));
+    return raw;
+  }
+
+  /** @return whether the tuples satisfy the predicate, evaluated through the expression tree */
+  bool Interpret(const Tuple *left_tuple, const Tuple *right_tuple) const {
+    if (is_join_) {
+      return predicate_->EvaluateJoin(left_tuple, left_schema_, right_tuple, right_schema_).GetAs<bool>();
+    }
+    return predicate_->Evaluate(left_tuple, left_schema_).GetAs<bool>();
+  }
+
+  /** The predicate, nullptr if every tuple satisfies it */
+  const AbstractExpression *predicate_{nullptr};
+  /** Whether the predicate is evaluated on pairs of tuples */
+  bool is_join_{false};
+  /** The schema of the tuples, of the left tuples for a join */
+  const Schema *left_schema_{nullptr};
+  /** The schema of the right tuples of a join */
+  const Schema *right_schema_{nullptr};
+  /** The specialized comparison, nullptr if the predicate is interpreted */
+  CompareFunction compare_{nullptr};
+  /** The left operand of the comparison */
+  ColumnOperand lhs_;
+  /** The right operand of the comparison, if it is a column */
+  ColumnOperand rhs_;
+  /** The right operand of the comparison, if it is a constant */
+  int64_t constant_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// executor_context.h
+//
+// Identification: src/include/execution/executor_context.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager.h"
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+/**
+ * ExecutorContext stores all the context necessary to run an executor.
+ */
+class ExecutorContext {
+ public:
+  /** The default number of bytes a single executor may keep in memory before it spills to temporary pages */
+  static constexpr size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+  /** By default executors run on the calling thread only */
+  static constexpr size_t DEFAULT_DEGREE_OF_PARALLELISM = 1;
+
+  /**
+   * Creates an ExecutorContext for the transaction that is executing the query.
+   * @param transaction The transaction executing the query
+   * @param catalog The catalog that the executor uses
+   * @param bpm The buffer pool manager that the executor uses
+   * @param txn_mgr The transaction manager that the executor uses
+   * @param lock_mgr The lock manager that the executor uses
+   */
+  ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
+                  LockManager *lock_mgr)
+      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+
+  ~ExecutorContext() = default;
+
+  DISALLOW_COPY_AND_MOVE(ExecutorContext);
+
+  /** @return the running transaction */
+  Transaction *GetTransaction() const { return transaction_; }
+
+  /** @return the catalog */
+  Catalog *GetCatalog() { return catalog_; }
+
+  /** @return the buffer pool manager */
+  BufferPoolManager *GetBufferPoolManager() { return bpm_; }
+
+  /** @return the log manager - don't worry about it for now */
+  LogManager *GetLogManager() { return nullptr; }
+
+  /** @return the lock manager */
+  LockManager *GetLockManager() { return lock_mgr_; }
+
+  /** @return the transaction manager */
+  TransactionManager *GetTransactionManager() { return txn_mgr_; }
+
+  /** @return the number of bytes a single executor may keep in memory */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  /**
+   * Set the memory budget of the executors running in this context.
+   * @param memory_budget the number of bytes a single executor may keep in memory
+   */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return the number of threads a single executor may use */
+  size_t GetDegreeOfParallelism() const { return degree_of_parallelism_; }
+
+  /**
+   * Set the degree of parallelism of the executors running in this context.
+   * @param degree_of_parallelism the number of threads a single executor may use, at least 1
+   */
+  void SetDegreeOfParallelism(size_t degree_of_parallelism) {
+    BUSTUB_ASSERT(degree_of_parallelism > 0, "The degree of parallelism must be positive.");
+    degree_of_parallelism_ = degree_of_parallelism;
+  }
+
+ private:
+  /** The transaction context associated with this executor context */
+  Transaction *transaction_;
+  /** The datbase catalog associated with this executor context */
+  Catalog *catalog_;
+  /** The buffer pool manager associated with this executor context */
+  BufferPoolManager *bpm_;
+  /** The transaction manager associated with this executor context */
+  TransactionManager *txn_mgr_;
+  /** The lock manager associated with this executor context */
+  LockManager *lock_mgr_;
+  /** The memory budget of a single executor, in bytes */
+  size_t memory_budget_{DEFAULT_MEMORY_BUDGET};
+  /** The number of threads a single executor may use */
+  size_t degree_of_parallelism_{DEFAULT_DEGREE_OF_PARALLELISM};
+};
+
+}  // namespace bustub
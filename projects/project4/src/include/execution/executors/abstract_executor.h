@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// abstract_executor.h
+//
+// Identification: src/include/execution/executors/abstract_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+class RuntimeFilter;
+
+/**
+ * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * This is the base class from which all executors in the BustTub execution
+ * engine inherit, and defines the minimal interface that all executors support.
+ */
+class AbstractExecutor {
+ public:
+  /**
+   * Construct a new AbstractExecutor instance.
+   * @param exec_ctx the executor context that the executor runs with
+   */
+  explicit AbstractExecutor(ExecutorContext *exec_ctx) : exec_ctx_{exec_ctx} {}
+
+  /** Virtual destructor. */
+  virtual ~AbstractExecutor() = default;
+
+  /**
+   * Initialize the executor.
+   * @warning This function must be called before Next() is called!
+   */
+  virtual void Init() = 0;
+
+  /**
+   * Yield the next tuple from this executor.
+   * @param[out] tuple The next tuple produced by this executor
+   * @param[out] rid The next tuple RID produced by this executor
+   * @return `true` if the executor produced a tuple, `false` if there are no more tuples
+   */
+  virtual bool Next(Tuple *tuple, RID *rid) = 0;
+
+  /**
+   * Yield the next batch of tuples from this executor.
+   *
+   * The default implementation adapts Next() for executors that are not batch-aware: it pulls
+   * tuples one at a time until the batch is full. Executors that can produce their output a batch
+   * at a time override it. A consumer should drive an executor through either Next() or NextBatch().
+   * @param[out] batch The batch to fill, it is reset to the output schema of this executor
+   * @return `true` if at least one tuple was selected into the batch, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
+  /**
+   * Hand the executor a filter on the keys of its output rows, built at runtime by a parent join.
+   *
+   * An executor that accepts the filter may drop any row whose key the filter rules out; rows it keeps
+   * are still checked by the join. The default implementation declines.
+   * @param filter The filter, nullptr to remove a filter set before. It must outlive its use by the executor
+   * @return `true` if the executor applies the filter
+   */
+  virtual bool SetRuntimeFilter(const RuntimeFilter *filter) { return false; }
+
+  /** @return The schema of the tuples that this executor produces */
+  virtual const Schema *GetOutputSchema() = 0;
+
+  /** @return The executor context in which this executor runs */
+  ExecutorContext *GetExecutorContext() { return exec_ctx_; }
+
+ protected:
+  /** The executor context in which the executor runs */
+  ExecutorContext *exec_ctx_;
+};
+}  // namespace bustub
@@ -0,0 +1,380 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.h
+//
+// Identification: src/include/execution/executors/aggregation_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/tmp_tuple_run.h"
+#include "execution/worker_pool.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * A simplified hash table that has all the necessary functionality for aggregations.
+ */
+class SimpleAggregationHashTable {
+ public:
+  /**
+   * Construct a new SimpleAggregationHashTable instance.
+   * @param agg_exprs the aggregation expressions
+   * @param agg_types the types of aggregations
+   */
+  SimpleAggregationHashTable(const std::vector<const AbstractExpression *> &agg_exprs,
+                             const std::vector<AggregationType> &agg_types)
+      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+
+  /** @return The initial aggregrate value for this aggregation executor */
+  AggregateValue GenerateInitialAggregateValue() {
+    std::vector<Value> values{};
+    for (const auto &agg_type : agg_types_) {
+      switch (agg_type) {
+        case AggregationType::CountAggregate:
+          // Count starts at zero.
+          values.emplace_back(ValueFactory::GetIntegerValue(0));
+          break;
+        case AggregationType::SumAggregate:
+          // Sum starts at zero.
+          values.emplace_back(ValueFactory::GetIntegerValue(0));
+          break;
+        case AggregationType::MinAggregate:
+          // Min starts at INT_MAX.
+          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
+          break;
+        case AggregationType::MaxAggregate:
+          // Max starts at INT_MIN.
+          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN));
+          break;
+      }
+    }
+    return {values};
+  }
+
+  /**
+   * Combines the input into the aggregation result.
+   * @param[out] result The output aggregate value
+   * @param input The input value
+   */
+  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+          // Count increases by one.
+          result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
+          break;
+        case AggregationType::SumAggregate:
+          // Sum increases by addition.
+          result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
+          break;
+        case AggregationType::MinAggregate:
+          // Min is just the min.
+          result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          // Max is just the max.
+          result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
+          break;
+      }
+    }
+  }
+
+  /**
+   * Merges a partial aggregation result into another one. It follows CombineAggregateValues, except that a partial
+   * count is added up rather than counted as a single input.
+   * @param[out] result The output aggregate value
+   * @param partial The partial aggregate value, of the same key
+   */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Add(partial.aggregates_[i]);
+          break;
+        case AggregationType::MinAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Min(partial.aggregates_[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Max(partial.aggregates_[i]);
+          break;
+      }
+    }
+  }
+
+  /**
+   * Inserts a value into the hash table and then combines it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param agg_val the value to be inserted
+   */
+  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    if (ht_.count(agg_key) == 0) {
+      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    }
+    CombineAggregateValues(&ht_[agg_key], agg_val);
+  }
+
+  /**
+   * Find the aggregate of a key, inserting the key with the initial aggregate if the table is within a memory budget.
+   * @param agg_key the key to be found
+   * @param memory_budget the number of bytes the table may take before it stops taking new keys
+   * @return the aggregate of the key, nullptr if the key is not in the table and the table is full
+   */
+  AggregateValue *FindOrInsert(const AggregateKey &agg_key, size_t memory_budget) {
+    auto iter = ht_.find(agg_key);
+    if (iter == ht_.end()) {
+      if (memory_usage_ >= memory_budget) {
+        return nullptr;
+      }
+      memory_usage_ += EntryMemoryUsage(agg_key);
+      iter = ht_.emplace(agg_key, GenerateInitialAggregateValue()).first;
+    }
+    return &iter->second;
+  }
+
+  /** Remove all keys from the table */
+  void Clear() {
+    ht_.clear();
+    memory_usage_ = 0;
+  }
+
+  /** @return The estimated number of bytes taken by the keys inserted through FindOrInsert() */
+  size_t GetMemoryUsage() const { return memory_usage_; }
+
+  /** An iterator over the aggregation hash table */
+  class Iterator {
+   public:
+    /** Creates an iterator for the aggregate map. */
+    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+
+    /** @return The key of the iterator */
+    const AggregateKey &Key() { return iter_->first; }
+
+    /** @return The value of the iterator */
+    const AggregateValue &Val() { return iter_->second; }
+
+    /** @return The iterator before it is incremented */
+    Iterator &operator++() {
+      ++iter_;
+      return *this;
+    }
+
+    /** @return `true` if both iterators are identical */
+    bool operator==(const Iterator &other) { return this->iter_ == other.iter_; }
+
+    /** @return `true` if both iterators are different */
+    bool operator!=(const Iterator &other) { return this->iter_ != other.iter_; }
+
+   private:
+    /** Aggregates map */
+    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+  };
+
+  /** @return Iterator to the start of the hash table */
+  Iterator Begin() const { return Iterator{ht_.cbegin()}; }
+
+  /** @return Iterator to the end of the hash table */
+  Iterator End() const { return Iterator{ht_.cend()}; }
+
+ private:
+  /** @return The estimated number of bytes a key and its aggregate take in the table */
+  size_t EntryMemoryUsage(const AggregateKey &agg_key) const {
+    // The node of the map holds the key, the aggregate and the cached hash next to its pointer to the next node
+    size_t bytes = sizeof(AggregateKey) + sizeof(AggregateValue) + 2 * sizeof(void *) +
+                   (agg_key.group_bys_.size() + agg_types_.size()) * sizeof(Value);
+    for (const auto &value : agg_key.group_bys_) {
+      if (value.GetTypeId() == TypeId::VARCHAR) {
+        bytes += value.GetLength();
+      }
+    }
+    return bytes;
+  }
+
+  /** The hash table is just a map from aggregate keys to aggregate values */
+  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  /** The estimated number of bytes taken by the keys inserted through FindOrInsert() */
+  size_t memory_usage_{0};
+  /** The aggregate expressions that we have */
+  const std::vector<const AbstractExpression *> &agg_exprs_;
+  /** The types of aggregations that we have */
+  const std::vector<AggregationType> &agg_types_;
+};
+
+/**
+ * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
+ * over the tuples produced by a child executor.
+ *
+ * The aggregation hash table takes new groups until it outgrows the memory budget of the executor context. From
+ * then on the groups already in the table keep being aggregated in memory, so the groups seen first and most often
+ * never leave it, while the tuples of any other group are partitioned by the hash of their group and spilled to
+ * temporary pages. Once the groups in memory are handed out, each spilled partition is aggregated on its own in the
+ * same way, being partitioned again with a different hash if it still does not fit.
+ *
+ * With a degree of parallelism above one in the executor context, the aggregation runs in two phases on a pool
+ * of that many threads, kept for the lifetime of the executor. Every thread pulls the next child batch itself,
+ * one thread at a time, and aggregates it into a table of its own while the others pull or aggregate theirs,
+ * until the child is exhausted. Then every thread merges one hash partition of the groups of all these tables
+ * into a final table, the final tables are handed out one after the other. If the thread tables outgrow the
+ * memory budget, they are merged into the single table instead and the rest of the child is aggregated on the
+ * calling thread, spilling as above.
+ */
+class AggregationExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new AggregationExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The insert plan to be executed
+   * @param child_executor The child executor from which inserted tuples are pulled (may be `nullptr`)
+   */
+  AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                      std::unique_ptr<AbstractExecutor> &&child);
+
+  /** Initialize the aggregation */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the insert.
+   * @param[out] tuple The next tuple produced by the insert
+   * @param[out] rid The next tuple RID produced by the insert
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The batch filled with the next groups that satisfy the having clause
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the aggregation */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Do not use or remove this function, otherwise you will get zero points. */
+  const AbstractExecutor *GetChildExecutor() const;
+
+ private:
+  /** @return The tuple as an AggregateKey */
+  AggregateKey MakeAggregateKey(const Tuple *tuple) {
+    std::vector<Value> keys;
+    for (const auto &expr : plan_->GetGroupBys()) {
+      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+    }
+    return {keys};
+  }
+
+  /** @return The tuple as an AggregateValue */
+  AggregateValue MakeAggregateValue(const Tuple *tuple) {
+    std::vector<Value> vals;
+    for (const auto &expr : plan_->GetAggregates()) {
+      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+    }
+    return {vals};
+  }
+
+  /** @return The row of a child batch as an AggregateKey */
+  AggregateKey MakeAggregateKey(const TupleBatch &batch, uint32_t row_idx) {
+    std::vector<Value> keys;
+    for (const auto &expr : plan_->GetGroupBys()) {
+      keys.emplace_back(batch.EvaluateAt(expr, row_idx));
+    }
+    return {keys};
+  }
+
+  /** @return The row of a child batch as an AggregateValue */
+  AggregateValue MakeAggregateValue(const TupleBatch &batch, uint32_t row_idx) {
+    std::vector<Value> vals;
+    for (const auto &expr : plan_->GetAggregates()) {
+      vals.emplace_back(batch.EvaluateAt(expr, row_idx));
+    }
+    return {vals};
+  }
+
+  /** The number of partitions the tuples of the groups that do not fit into memory are spread over */
+  static constexpr uint32_t PARTITION_FANOUT = 8;
+  /** Spilled partitions are partitioned again at most this many times, deeper ones are aggregated in memory anyway */
+  static constexpr uint32_t MAX_PARTITION_LEVEL = 4;
+
+  /** The child tuples of groups that did not fit into memory, still to be aggregated */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleRun> run_;
+    /** How many times these tuples have been partitioned */
+    uint32_t level_;
+  };
+
+  /**
+   * Spill a child tuple whose group is not in the full hash table.
+   * @param agg_key The group of the tuple
+   * @param tuple The child tuple
+   * @param level The partitioning level of the tuple, its partition is picked with a hash seeded by it
+   */
+  void SpillTuple(const AggregateKey &agg_key, const Tuple &tuple, uint32_t level);
+
+  /**
+   * Aggregate the child on several threads, until it is exhausted or the thread tables outgrow the memory budget.
+   * @return `true` if the child is exhausted and the groups are in merged_tables_, `false` if they are in aht_
+   */
+  bool ParallelAggregate();
+
+  /**
+   * Aggregate a batch into a table, may run concurrently with other batches going into other tables.
+   * @param batch The child batch
+   * @param table The table, it takes every new group
+   */
+  void AggregateMorsel(const TupleBatch &batch, SimpleAggregationHashTable *table);
+
+  /** Queue the partitions spilled while aggregating tuples of a partitioning level */
+  void FinishSpilling(uint32_t level);
+
+  /**
+   * Make aht_iterator_ point at a group, aggregating the next spilled partition once the hash table is exhausted.
+   * @return `false` if there are no more groups
+   */
+  bool LoadGroups();
+
+ private:
+  /** The aggregation plan node */
+  const AggregationPlanNode *plan_;
+  /** The child executor that produces tuples over which the aggregation is computed */
+  std::unique_ptr<AbstractExecutor> child_;
+  /** Simple aggregation hash table */
+  SimpleAggregationHashTable aht_;
+  /** The table whose groups are being handed out, aht_ or one of merged_tables_ */
+  const SimpleAggregationHashTable *output_table_{nullptr};
+  /** Simple aggregation hash table iterator */
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The final tables of a parallel aggregation, one per hash partition of the groups */
+  std::vector<std::unique_ptr<SimpleAggregationHashTable>> merged_tables_;
+  /** The position in merged_tables_ of output_table_ */
+  size_t merged_table_idx_{0};
+  /** The memory budget of the executor, in bytes */
+  size_t memory_budget_{0};
+  /** The threads of the parallel aggregation, nullptr until the aggregation first runs in parallel */
+  std::unique_ptr<WorkerPool> worker_pool_;
+  /** The partitions being spilled by the current pass, nullptr until some tuple goes to them */
+  std::vector<std::unique_ptr<TmpTupleRun>> spill_runs_;
+  /** The spilled partitions still to be aggregated */
+  std::deque<SpilledPartition> spilled_partitions_;
+};
+}  // namespace bustub
@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// distinct_executor.h
+//
+// Identification: src/include/execution/executors/distinct_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/distinct_plan.h"
+#include "execution/sort_key.h"
+#include "execution/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * HashDistinctTable is the set of the rows seen by a hash distinct.
+ *
+ * A row is only kept as its key, the normalized values of its columns, so two rows are duplicates if and only if
+ * their keys have the same bytes. The keys are packed into a single contiguous arena, each one preceded by its size.
+ * The table is open-addressing with linear probing: a slot caches the hash of its key next to the offset of the key
+ * bytes, so a probe only compares key bytes when the hashes match.
+ */
+class HashDistinctTable {
+ public:
+  /**
+   * Construct a new HashDistinctTable instance.
+   */
+  HashDistinctTable() = default;
+
+  /**
+   * Check whether a key is in the table.
+   * @param key the key to look up
+   * @param hash the hash of the key
+   * @return `true` if the key was inserted before
+   */
+  bool Contains(const SortKey &key, hash_t hash) const {
+    if (num_keys_ == 0) {
+      return false;
+    }
+    for (size_t slot_idx = hash & (slots_.size() - 1);; slot_idx = (slot_idx + 1) & (slots_.size() - 1)) {
+      const Slot &slot = slots_[slot_idx];
+      if (slot.key_offset_ == NO_KEY) {
+        return false;
+      }
+      if (slot.hash_ == hash && KeyEquals(slot, key)) {
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Insert a key that is not in the table.
+   * @param key the key to be copied into the table
+   * @param hash the hash of the key
+   */
+  void Insert(const SortKey &key, hash_t hash);
+
+  /**
+   * Check whether a key can be inserted without the table outgrowing a memory budget.
+   * @param key the key to be inserted
+   * @param memory_budget the memory budget, in bytes
+   * @return `true` if the table still fits into the budget after the insert
+   */
+  bool HasRoom(const SortKey &key, size_t memory_budget) const {
+    size_t num_slots = (num_keys_ + 1) * 2 > slots_.size() ? std::max<size_t>(slots_.size() * 2, 16) : slots_.size();
+    return num_slots * sizeof(Slot) + keys_.size() + sizeof(uint32_t) + key.GetSize() <= memory_budget;
+  }
+
+  /** Remove all keys, keeping the allocated memory */
+  void Clear() {
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    keys_.clear();
+    num_keys_ = 0;
+  }
+
+  /** @return the number of keys in the table */
+  size_t GetNumKeys() const { return num_keys_; }
+
+  /** @return the number of bytes allocated by the table */
+  size_t GetMemoryUsage() const { return slots_.capacity() * sizeof(Slot) + keys_.capacity(); }
+
+ private:
+  /** The key offset of an empty slot */
+  static constexpr size_t NO_KEY = std::numeric_limits<size_t>::max();
+
+  /** A slot of the open-addressing table */
+  struct Slot {
+    /** The hash of the key */
+    hash_t hash_{0};
+    /** The offset of the key in keys_, NO_KEY if the slot is empty */
+    size_t key_offset_{NO_KEY};
+  };
+
+  /** @return `true` if the key of a slot has the same bytes as a key */
+  bool KeyEquals(const Slot &slot, const SortKey &key) const {
+    uint32_t key_size;
+    memcpy(&key_size, keys_.data() + slot.key_offset_, sizeof(uint32_t));
+    return key_size == key.GetSize() &&
+           memcmp(keys_.data() + slot.key_offset_ + sizeof(uint32_t), key.GetData(), key_size) == 0;
+  }
+
+  /** Double the number of slots and reinsert the keys */
+  void Grow();
+
+  /** The slots, their number is a power of two */
+  std::vector<Slot> slots_;
+  /** The keys, each one is its size followed by its bytes */
+  std::vector<char> keys_;
+  /** The number of keys in the table */
+  size_t num_keys_{0};
+};
+
+/**
+ * DistinctExecutor removes duplicate rows from child ouput.
+ *
+ * The rows are pipelined: a row is produced as soon as its key is inserted into the table, and a duplicate is
+ * dropped after a single probe. Once the table would outgrow the memory budget of the executor context, the keys
+ * it holds keep filtering their duplicates, but a row with a new key is spilled to one of PARTITION_FANOUT
+ * temporary runs, chosen by the hash of the key. All rows of such a key land in the same run, so once the child is
+ * exhausted each run is deduplicated on its own with an emptied table, and spills again if it is still too large.
+ */
+class DistinctExecutor : public AbstractExecutor {
+ public:
+  /** The number of partitions the rows are spilled to */
+  static constexpr size_t PARTITION_FANOUT = 8;
+  /** The deepest partitioning, a partition this deep is deduplicated in memory whatever its size */
+  static constexpr uint32_t MAX_PARTITION_LEVEL = 4;
+
+  /**
+   * Construct a new DistinctExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The limit plan to be executed
+   * @param child_executor The child executor from which tuples are pulled
+   */
+  DistinctExecutor(ExecutorContext *exec_ctx, const DistinctPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the distinct */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the distinct.
+   * @param[out] tuple The next tuple produced by the distinct
+   * @param[out] rid The next tuple RID produced by the distinct
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the distinct */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /** A run of spilled rows that is yet to be deduplicated */
+  struct SpilledPartition {
+    /** The spilled rows */
+    std::unique_ptr<TmpTupleRun> run_;
+    /** The number of times the rows have been partitioned */
+    uint32_t level_;
+  };
+
+  /**
+   * Pull the next row, from the child executor and then from the spilled partitions.
+   * @param[out] tuple The next row
+   * @param[out] rid The RID of the next row
+   * @return `true` if a row was pulled, `false` if there are no more rows
+   */
+  bool NextInput(Tuple *tuple, RID *rid);
+
+  /**
+   * Spill a row with a key that is not in the table.
+   * @param tuple the row
+   * @param hash the hash of the key of the row
+   */
+  void SpillTuple(const Tuple &tuple, hash_t hash);
+
+  /** Close the spilled runs of the current level and queue them for deduplication */
+  void FinishSpilling();
+
+  /** Build the key of a row from all of its columns */
+  void MakeKey(const Tuple &tuple) {
+    key_.Clear();
+    for (uint32_t col_idx = 0; col_idx < GetOutputSchema()->GetColumnCount(); col_idx++) {
+      key_.Append(tuple.GetValue(GetOutputSchema(), col_idx), OrderByType::ASC);
+    }
+  }
+
+  /** The distinct plan node to be executed */
+  const DistinctPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The memory budget of the executor, in bytes */
+  size_t memory_budget_{0};
+  /** The keys of the rows produced so far, for the child input or for the partition being read */
+  HashDistinctTable hash_table_;
+  /** Scratch space for the key of the current row */
+  SortKey key_;
+  /** Whether the child executor has no more tuples */
+  bool child_exhausted_{false};
+  /** The partition being read, nullptr while the child input is read */
+  std::unique_ptr<TmpTupleRun> partition_run_;
+  /** The number of times the rows being read have been partitioned */
+  uint32_t level_{0};
+  /** The runs being spilled to, one per partition, nullptr for a partition without rows */
+  std::vector<std::unique_ptr<TmpTupleRun>> spill_runs_;
+  /** The spilled partitions that are yet to be deduplicated */
+  std::deque<SpilledPartition> spilled_partitions_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.h
+//
+// Identification: src/include/execution/executors/exchange_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/morsel_cursor.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ExchangeExecutor gathers the output of several worker pipelines that run on their own threads into a single
+ * stream, for its parent on the calling thread.
+ *
+ * The workers are executors producing the same output schema over disjoint parts of the input, typically scans
+ * sharing a MorselCursor, see CreateParallelScan(). They are started by the first pull, so a runtime filter can
+ * still be pushed down to them after Init(). Each worker fills batches that are handed over through a bounded
+ * queue, so the workers never run too far ahead of the parent. Rows come out in no particular order.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  /** The number of batches each worker may have waiting in the queue */
+  static constexpr size_t QUEUED_BATCHES_PER_WORKER = 2;
+
+  /**
+   * Construct a new ExchangeExecutor instance.
+   * @param exec_ctx The executor context
+   * @param workers The worker pipelines, with the same output schema, at least one
+   * @param cursor The cursor the workers take their morsels from, reset by Init(). nullptr if there is none
+   */
+  ExchangeExecutor(ExecutorContext *exec_ctx, std::vector<std::unique_ptr<AbstractExecutor>> &&workers,
+                   std::unique_ptr<MorselCursor> &&cursor);
+
+  /** Stop the workers that are still running */
+  ~ExchangeExecutor() override;
+
+  /**
+   * Create the executor of a sequential scan plan. With a degree of parallelism above one, the table is scanned
+   * by that many SeqScanExecutors sharing a MorselCursor, gathered by an ExchangeExecutor.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @return The executor of the scan
+   */
+  static std::unique_ptr<AbstractExecutor> CreateParallelScan(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
+
+  /** Initialize the exchange, stopping the workers of a previous run and initializing every worker */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the exchange.
+   * @param[out] tuple The next tuple produced by some worker
+   * @param[out] rid The next tuple RID produced by some worker
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the exchange, as produced by some worker.
+   * @param[out] batch The next batch produced by some worker
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /**
+   * Hand the runtime filter to every worker, only before the workers are started.
+   * @param filter The filter, nullptr to remove the current one
+   * @return `true` if every worker applies the filter
+   */
+  bool SetRuntimeFilter(const RuntimeFilter *filter) override;
+
+  /** @return The output schema for the exchange, the one of the workers */
+  const Schema *GetOutputSchema() override { return workers_[0]->GetOutputSchema(); };
+
+ private:
+  /** Start a thread for every worker */
+  void StartWorkers();
+
+  /** Make the running workers stop at their next batch and wait for them */
+  void StopWorkers();
+
+  /**
+   * Drive a worker until it is exhausted or stopped, queueing its batches.
+   * @param worker_idx The worker
+   */
+  void RunWorker(size_t worker_idx);
+
+  /**
+   * Take the next batch out of the queue, waiting for the workers if it is empty.
+   * @param[out] batch The batch
+   * @return `false` if every worker is done and the queue is empty
+   * @throws the first exception thrown by a worker
+   */
+  bool PullBatch(TupleBatch *batch);
+
+  /** The worker pipelines */
+  std::vector<std::unique_ptr<AbstractExecutor>> workers_;
+  /** The cursor the workers take their morsels from, nullptr if there is none */
+  std::unique_ptr<MorselCursor> cursor_;
+  /** The threads running the workers, empty until the first pull */
+  std::vector<std::thread> threads_;
+  /** Whether the workers have been started since Init() */
+  bool started_{false};
+  /** Protects the queue and the state of the workers below */
+  std::mutex latch_;
+  /** Signaled when a batch is queued or a worker is done */
+  std::condition_variable not_empty_;
+  /** Signaled when a batch is taken out of the queue or the workers are stopped */
+  std::condition_variable not_full_;
+  /** The batches produced by the workers and not pulled yet */
+  std::deque<TupleBatch> queue_;
+  /** The number of workers that are still producing */
+  size_t num_running_{0};
+  /** Whether the workers have to stop */
+  bool stopping_{false};
+  /** The first exception thrown by a worker */
+  std::exception_ptr error_;
+  /** The batch Next() hands out tuples from, and the position of its next selected row */
+  TupleBatch batch_;
+  uint32_t sel_idx_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_executor.h
+//
+// Identification: src/include/execution/executors/external_sort_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/sort_key.h"
+#include "execution/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ExternalSortExecutor sorts the tuples of its child executor on a list of ORDER BY expressions.
+ *
+ * The child tuples are collected in memory with their normalized sort keys until they outgrow the memory budget
+ * of the executor context, then they are sorted and spilled to temporary pages as a sorted run. Once the child is
+ * exhausted, an input that fit into memory is handed out directly. Otherwise the runs are merged with a loser
+ * tree, in several passes if there are more runs than pages the merge may pin at once. The sort is stable.
+ */
+class ExternalSortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ExternalSortExecutor instance.
+   * @param exec_ctx The executor context
+   * @param child_executor The child executor whose tuples are sorted
+   * @param order_bys The ORDER BY expressions with their directions, evaluated on the output schema of the child
+   */
+  ExternalSortExecutor(ExecutorContext *exec_ctx, std::unique_ptr<AbstractExecutor> &&child_executor,
+                       std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys);
+
+  /** Initialize the sort, it consumes the whole child */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the sort.
+   * @param[out] tuple The next tuple produced by the sort
+   * @param[out] rid The next tuple RID produced by the sort
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the sort, the one of its child */
+  const Schema *GetOutputSchema() override { return child_executor_->GetOutputSchema(); };
+
+  /** @return The ORDER BY expressions with their directions */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /**
+   * Take the child executor away, for an executor that replaces the sort. The sort cannot be used afterwards.
+   * @return The child executor
+   */
+  std::unique_ptr<AbstractExecutor> ReleaseChildExecutor() { return std::move(child_executor_); }
+
+  /**
+   * Build the sort key of a tuple.
+   * @param order_bys The ORDER BY expressions with their directions
+   * @param tuple The tuple
+   * @param schema The schema of the tuple
+   * @param[out] sort_key The key
+   */
+  static void MakeKey(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys,
+                      const Tuple &tuple, const Schema *schema, SortKey *sort_key);
+
+ private:
+  /** A child tuple with its sort key */
+  struct SortEntry {
+    SortKey key_;
+    Tuple tuple_;
+  };
+
+  /** A sorted run being merged, with its smallest tuple not merged yet */
+  struct MergeSource {
+    TmpTupleRun *run_;
+    SortKey key_;
+    Tuple tuple_;
+    bool exhausted_;
+  };
+
+  /** @return The estimated number of bytes an entry takes in memory */
+  static size_t EntryMemoryUsage(const SortEntry &entry) {
+    return sizeof(SortEntry) + entry.key_.GetSize() + entry.tuple_.GetLength();
+  }
+
+  /** Sort the entries in memory and spill them as a new run */
+  void SpillRun();
+
+  /**
+   * Merge runs pass after pass until at most merge_fan_in_ are left, each pass merges groups of adjacent runs.
+   * Adjacent runs are merged so that tuples with equal keys keep their order.
+   */
+  void MergeRunsToFanIn();
+
+  /**
+   * Start merging a range of runs.
+   * @param begin The first run to merge
+   * @param end The run after the last one to merge
+   */
+  void StartMerge(size_t begin, size_t end);
+
+  /**
+   * Take the smallest tuple out of the runs being merged.
+   * @param[out] tuple The tuple
+   * @return `false` if all runs are exhausted
+   */
+  bool MergeNext(Tuple *tuple);
+
+  /** Read the next tuple of a merge source and build its key */
+  void AdvanceSource(MergeSource *source);
+
+  /** @return `true` if the head of source `a` comes before the one of source `b`, an exhausted source comes last */
+  bool SourceLess(size_t a, size_t b) const {
+    const MergeSource &source_a = merge_sources_[a];
+    const MergeSource &source_b = merge_sources_[b];
+    if (source_a.exhausted_ || source_b.exhausted_) {
+      return !source_a.exhausted_ && source_b.exhausted_;
+    }
+    int cmp = source_a.key_.Compare(source_b.key_);
+    // Equal keys come out of the earlier run first, which keeps the sort stable
+    return cmp < 0 || (cmp == 0 && a < b);
+  }
+
+  /**
+   * Play the matches of a subtree of the loser tree, storing the loser of each match in its node.
+   * @param node The root of the subtree, nodes from merge_sources_.size() on are the sources
+   * @return The winner of the subtree
+   */
+  size_t BuildLoserTree(size_t node);
+
+  /** The child executor whose tuples are sorted */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The ORDER BY expressions with their directions */
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  /** The memory budget of the executor, in bytes */
+  size_t memory_budget_{0};
+  /** The number of runs merged at once, each of them pins a page */
+  size_t merge_fan_in_{0};
+  /** The entries held in memory */
+  std::vector<SortEntry> entries_;
+  /** The number of bytes taken by the entries */
+  size_t entries_bytes_{0};
+  /** The position of the next entry to hand out, if the input fit into memory */
+  size_t entry_idx_{0};
+  /** The sorted runs, in the order they were spilled */
+  std::vector<std::unique_ptr<TmpTupleRun>> runs_;
+  /** The runs being merged */
+  std::vector<MergeSource> merge_sources_;
+  /** The loser tree, node 0 holds the overall winner and every other node the loser of its match */
+  std::vector<size_t> loser_tree_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,457 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/hash_join_key.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/runtime_filter.h"
+#include "execution/tmp_tuple_run.h"
+#include "execution/worker_pool.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * A hash table that has all the necessary functionality for hash join.
+ *
+ * The left tuples are copied, in the TablePage tuple format, into a single contiguous arena. Every entry
+ * starts with the offset of the previous entry of the same key, so duplicate keys are chained inside the arena.
+ * The table is open-addressing with linear probing: a slot caches the hash of its key next to the offsets of
+ * the key bytes and of the latest entry of the key, so a probe only compares key bytes when the hashes match.
+ */
+class HashJoinTable {
+ public:
+  /** The offset that marks the end of a chain of entries */
+  static constexpr size_t NO_ENTRY = std::numeric_limits<size_t>::max();
+
+  /**
+   * Construct a new HashJoinTable instance.
+   */
+  HashJoinTable() = default;
+
+  /**
+   * Insert a tuple under a key.
+   * @param hash_key the key, it must not have NULL values
+   * @param tuple the tuple to be copied into the table
+   */
+  void Insert(const HashJoinKey &hash_key, const Tuple &tuple);
+
+  /**
+   * Look up a key without modifying the table, so it may be called from several threads at once.
+   * @param hash_key the key to look up
+   * @return the first entry of the key, NO_ENTRY if the key does not exist
+   */
+  size_t Find(const HashJoinKey &hash_key) const {
+    if (num_keys_ == 0) {
+      return NO_ENTRY;
+    }
+    for (size_t slot_idx = hash_key.GetHash() & (slots_.size() - 1);; slot_idx = (slot_idx + 1) & (slots_.size() - 1)) {
+      const Slot &slot = slots_[slot_idx];
+      if (slot.first_entry_ == NO_ENTRY) {
+        return NO_ENTRY;
+      }
+      if (slot.hash_ == hash_key.GetHash() && KeyEquals(slot, hash_key)) {
+        return slot.first_entry_;
+      }
+    }
+  }
+
+  /** @return the entry after an entry of the same key, NO_ENTRY if it is the last one */
+  size_t NextEntry(size_t entry) const {
+    size_t next_entry;
+    memcpy(&next_entry, arena_.data() + entry, sizeof(size_t));
+    return next_entry;
+  }
+
+  /**
+   * Read a column of the tuple of an entry, like Tuple::GetValue() but without copying the tuple.
+   * @param entry the entry
+   * @param schema the schema of the tuple
+   * @param col_idx the column to read
+   * @return the value of the column
+   */
+  Value GetValue(size_t entry, const Schema *schema, uint32_t col_idx) const {
+    const char *tuple_data = arena_.data() + entry + sizeof(size_t) + sizeof(uint32_t);
+    const Column &column = schema->GetColumn(col_idx);
+    const char *value_data = tuple_data + column.GetOffset();
+    if (!column.IsInlined()) {
+      // The inlined part of the column is the offset of its data in the tuple
+      uint32_t value_offset;
+      memcpy(&value_offset, value_data, sizeof(uint32_t));
+      value_data = tuple_data + value_offset;
+    }
+    return Value::DeserializeFrom(value_data, column.GetType());
+  }
+
+  /**
+   * Copy the tuple of an entry.
+   * @param entry the entry
+   * @param[out] tuple the tuple
+   */
+  void GetTuple(size_t entry, Tuple *tuple) const { tuple->DeserializeFrom(arena_.data() + entry + sizeof(size_t)); }
+
+  /** @return the number of distinct keys in the table */
+  size_t GetNumKeys() const { return num_keys_; }
+
+  /** @return the number of tuples in the table */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+  /** @return the number of bytes allocated by the table */
+  size_t GetMemoryUsage() const { return slots_.capacity() * sizeof(Slot) + keys_.capacity() + arena_.capacity(); }
+
+  /**
+   * Estimate the memory a table needs for some tuples, as if every tuple had its own single column key.
+   * @param num_tuples the number of tuples
+   * @param tuple_bytes the number of bytes of the tuples
+   * @return the estimated number of bytes
+   */
+  static size_t EstimateMemoryUsage(size_t num_tuples, size_t tuple_bytes) {
+    // Two slots per key at the maximum load factor, a key of 8 bytes, the chain offset and the tuple size
+    return num_tuples * (2 * sizeof(Slot) + sizeof(uint32_t) + sizeof(int64_t) + sizeof(size_t) + sizeof(uint32_t)) +
+           tuple_bytes;
+  }
+
+  /** An iterator over the keys of the hash join table */
+  class Iterator {
+   public:
+    /** Create an iterator that starts at a slot of the table */
+    Iterator(const HashJoinTable *table, size_t slot_idx) : table_{table}, slot_idx_{slot_idx} { SkipEmptySlots(); }
+
+    /**
+     * Copy the key of the iterator.
+     * @param[out] hash_key the key
+     */
+    void Key(HashJoinKey *hash_key) {
+      const Slot &slot = table_->slots_[slot_idx_];
+      uint32_t key_size;
+      memcpy(&key_size, table_->keys_.data() + slot.key_offset_, sizeof(uint32_t));
+      hash_key->Assign(table_->keys_.data() + slot.key_offset_ + sizeof(uint32_t), key_size, slot.hash_);
+    }
+
+    /** @return The hash of the key of the iterator */
+    hash_t Hash() { return table_->slots_[slot_idx_].hash_; }
+
+    /** @return The first entry of the key of the iterator */
+    size_t FirstEntry() { return table_->slots_[slot_idx_].first_entry_; }
+
+    /** @return The iterator after it is incremented */
+    Iterator &operator++() {
+      ++slot_idx_;
+      SkipEmptySlots();
+      return *this;
+    }
+
+    /** @return `true` if both iterators are identical */
+    bool operator==(const Iterator &other) { return this->slot_idx_ == other.slot_idx_; }
+
+    /** @return `true` if both iterators are different */
+    bool operator!=(const Iterator &other) { return this->slot_idx_ != other.slot_idx_; }
+
+   private:
+    void SkipEmptySlots() {
+      while (slot_idx_ < table_->slots_.size() && table_->slots_[slot_idx_].first_entry_ == NO_ENTRY) {
+        ++slot_idx_;
+      }
+    }
+
+    const HashJoinTable *table_;
+    size_t slot_idx_;
+  };
+
+  /** @return Iterator to the first key of the hash table */
+  Iterator Begin() const { return Iterator{this, 0}; }
+
+  /** @return Iterator to the end of the hash table */
+  Iterator End() const { return Iterator{this, slots_.size()}; }
+
+ private:
+  /** A slot of the open-addressing table, it is empty if first_entry_ is NO_ENTRY */
+  struct Slot {
+    hash_t hash_{0};
+    size_t key_offset_{0};
+    size_t first_entry_{NO_ENTRY};
+  };
+
+  /** @return `true` if the key of a slot is the given key */
+  bool KeyEquals(const Slot &slot, const HashJoinKey &hash_key) const {
+    uint32_t key_size;
+    memcpy(&key_size, keys_.data() + slot.key_offset_, sizeof(uint32_t));
+    return key_size == hash_key.GetSize() &&
+           memcmp(keys_.data() + slot.key_offset_ + sizeof(uint32_t), hash_key.GetData(), key_size) == 0;
+  }
+
+  /** Double the number of slots, the cached hashes place the keys without rehashing them */
+  void Grow();
+
+  /** The slots, their number is a power of two */
+  std::vector<Slot> slots_;
+  /** The keys, each is its size followed by its bytes */
+  std::vector<char> keys_;
+  /** The entries, each is the offset of the previous entry of its key followed by a serialized tuple */
+  std::vector<char> arena_;
+  size_t num_keys_{0};
+  size_t num_tuples_{0};
+};
+
+/**
+ * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ *
+ * The join is a hybrid hash join: as long as the build side fits into the memory budget of the executor
+ * context it stays in a single hash table. Once it outgrows the budget, it is split into PARTITION_FANOUT
+ * partitions and the largest ones are spilled to temporary pages until the rest fits again. Right tuples
+ * that hash to a resident partition are joined right away, the others are spilled next to their partition
+ * and the spilled pairs are joined one at a time after the right child is exhausted, being partitioned
+ * again first if their build side is still too large.
+ *
+ * With a degree of parallelism above one in the executor context, a build side that fits into memory is
+ * built by a pool of that many threads, kept for the lifetime of the executor: each hashes a share of the
+ * left batches and scatters the rows by partition, then each builds one partition table on its own. The probe
+ * then pulls one right batch per thread and probes them in parallel on the same pool, the output batches are
+ * gathered in order and handed out by the calling thread.
+ *
+ * Once a build side is resident, a Bloom filter over its keys is pushed into the right child, so a scan can
+ * drop the right rows that cannot match before it locks them or builds their output.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new HashJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The HashJoin join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch filled with the next join results
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Move the probe forward to the next (left, right) match, pulling right batches on demand.
+   * @return `true` if a match is available, `false` if the right side is exhausted
+   */
+  bool AdvanceProbe();
+
+  /**
+   * Evaluate the output columns for a match.
+   * @param left_table The table holding the matching left tuple
+   * @param left_entry The entry of the matching left tuple
+   * @param right_batch The batch holding the right row, nullptr if the right row is only available as right_tuple
+   * @param right_row_idx The right row in right_batch
+   * @param right_tuple The right row as a tuple, only used if needs_right_tuple_ or right_batch is nullptr
+   * @param left_tuple Scratch space for the left tuple, it is only copied out of the table if needs_left_tuple_
+   * @param[out] values The output values
+   */
+  void EvaluateOutputValues(const HashJoinTable &left_table, size_t left_entry, const TupleBatch *right_batch,
+                            uint32_t right_row_idx, const Tuple &right_tuple, Tuple *left_tuple,
+                            std::vector<Value> *values) const;
+
+  /**
+   * Build the join key of a row of a batch.
+   * @param key_exprs The key expressions, one per key column
+   * @param batch The batch
+   * @param row_idx The row
+   * @param[out] hash_key The key
+   */
+  static void MakeKey(const std::vector<const AbstractExpression *> &key_exprs, const TupleBatch &batch,
+                      uint32_t row_idx, HashJoinKey *hash_key);
+
+  /**
+   * Build the join key of a tuple.
+   * @param key_exprs The key expressions, one per key column
+   * @param tuple The tuple
+   * @param schema The schema of the tuple
+   * @param[out] hash_key The key
+   */
+  static void MakeKey(const std::vector<const AbstractExpression *> &key_exprs, const Tuple &tuple,
+                      const Schema *schema, HashJoinKey *hash_key);
+
+  /** The number of partitions the build side is split into once it outgrows the memory budget */
+  static constexpr uint32_t PARTITION_FANOUT = 8;
+  /** Spilled partitions are partitioned again at most this many times, deeper ones are loaded anyway */
+  static constexpr uint32_t MAX_PARTITION_LEVEL = 4;
+
+  /** A partition of the build side, it is resident in its own table until it gets spilled to runs */
+  struct HashJoinPartition {
+    /** The left tuples of the partition, empty once it is spilled */
+    HashJoinTable table_;
+    /** The spilled left and right tuples of the partition, nullptr while it is resident */
+    std::unique_ptr<TmpTupleRun> build_run_;
+    std::unique_ptr<TmpTupleRun> probe_run_;
+  };
+
+  /** The spilled left and right tuples of a partition that is still to be joined */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleRun> build_run_;
+    std::unique_ptr<TmpTupleRun> probe_run_;
+    /** How many times these tuples have been partitioned */
+    uint32_t level_;
+  };
+
+  /** @return The estimated memory needed to load all tuples of a run into a hash table */
+  static size_t EstimateSize(const TmpTupleRun &run) {
+    return HashJoinTable::EstimateMemoryUsage(run.GetNumTuples(), run.GetNumBytes());
+  }
+
+  /** @return The partition of a key, the level seeds the hash so every level splits differently */
+  static size_t PartitionOf(const HashJoinKey &hash_key, uint32_t level, size_t num_partitions) {
+    return SpillPartitionOf(hash_key.GetHash(), level, num_partitions);
+  }
+
+  /** @return The resident table that holds the left tuples of a key */
+  const HashJoinTable &ResidentTable(const HashJoinKey &hash_key) const {
+    return partitions_.empty() ? hash_table_ : partitions_[PartitionOf(hash_key, 0, partitions_.size())].table_;
+  }
+
+  /**
+   * Build one resident partition per thread from buffered left batches.
+   * @param left_batches The whole left side, it has to fit into the memory budget. The batches are emptied
+   */
+  void ParallelBuild(std::vector<TupleBatch> *left_batches);
+
+  /**
+   * Probe a right batch against the resident tables, may run concurrently with other morsels.
+   * @param right_batch The right batch to be probed
+   * @param[out] output The join results, appended as full batches
+   */
+  void ProbeMorsel(const TupleBatch &right_batch, std::vector<TupleBatch> *output) const;
+
+  /**
+   * Probe the next round of right batches in parallel, until some join result is gathered.
+   * @return `false` if the right side is exhausted and nothing is left in gathered_batches_
+   */
+  bool GatherParallelProbe();
+
+  /** Add a left tuple to the build side, partitioning and spilling it if it outgrows the memory budget */
+  void BuildTuple(const HashJoinKey &hash_key, const Tuple &left_tuple);
+
+  /** Move the single hash table into PARTITION_FANOUT resident partitions */
+  void SplitIntoPartitions();
+
+  /**
+   * Spill the largest resident partition to temporary pages.
+   * @return `false` if every partition is already spilled
+   */
+  bool SpillLargestPartition();
+
+  /** Queue the spilled partitions to be joined once the right child is exhausted */
+  void FinishPartitionedProbe();
+
+  /**
+   * Load the build side of the next spilled partition into hash_table_ and start reading its probe side.
+   * @return `false` if there are no more spilled partitions to be joined
+   */
+  bool LoadNextSpilledPartition();
+
+  /** Split a spilled partition whose build side does not fit into memory into partitions of the next level */
+  void SplitSpilledPartition(SpilledPartition *spilled_partition);
+
+  /** Build the runtime filter over the keys of a resident build side and push it into the right child */
+  void PushDownRuntimeFilter();
+
+  /** The NestedLoopJoin plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  /** The child executor that produces tuple for the left side of join */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The child executor that produces tuple for the right side of join */
+  std::unique_ptr<AbstractExecutor> right_child_;
+  /** The built hash table */
+  HashJoinTable hash_table_;
+  // The iterator is not required because the join phase is not a sequential scan
+  // HashJoinTable::Iterator hash_table_iter_;
+  /** The expressions of the key columns, on the left and on the right */
+  std::vector<const AbstractExpression *> left_key_exprs_;
+  std::vector<const AbstractExpression *> right_key_exprs_;
+  /** Output columns that copy a left column, nullptr for any other output column */
+  std::vector<const ColumnValueExpression *> left_columns_;
+  /** Output columns that copy a right column, nullptr for any other output column */
+  std::vector<const ColumnValueExpression *> right_columns_;
+  /** Whether some output column needs the left row as a tuple */
+  bool needs_left_tuple_{false};
+  /** Whether some output column needs the right row as a tuple */
+  bool needs_right_tuple_{false};
+  /** The right batch being probed */
+  TupleBatch right_batch_;
+  /** The position in the selection of the right batch to be probed next */
+  uint32_t right_sel_idx_{0};
+  /** Whether the right child has no more tuples */
+  bool right_exhausted_{false};
+  /** The right row being joined, its tuple is only built if needs_right_tuple_ */
+  uint32_t right_row_idx_{0};
+  Tuple right_tuple_;
+  /** The table holding the left tuples matching the right row */
+  const HashJoinTable *left_match_table_{nullptr};
+  /** The entry of the left tuple to be joined next, NO_ENTRY if there is no current match */
+  size_t left_match_entry_{HashJoinTable::NO_ENTRY};
+  /** Scratch space for a left tuple, only used if needs_left_tuple_ */
+  Tuple left_tuple_;
+  /** Scratch space for one output row */
+  std::vector<Value> output_values_;
+  /** The number of bytes the build side may keep in memory */
+  size_t memory_budget_{0};
+  /** The memory used by the resident build side */
+  size_t resident_bytes_{0};
+  /** The partitions of the build side, empty as long as it fits into hash_table_ */
+  std::vector<HashJoinPartition> partitions_;
+  /** Spilled partitions still to be joined, the last one is joined next */
+  std::vector<SpilledPartition> spilled_partitions_;
+  /** The right tuples of the spilled partition loaded into hash_table_, nullptr outside of that phase */
+  std::unique_ptr<TmpTupleRun> spilled_probe_run_;
+  /** The number of threads the join may use */
+  size_t degree_of_parallelism_{1};
+  /** The threads of the parallel build and probe, nullptr until the join first runs in parallel */
+  std::unique_ptr<WorkerPool> worker_pool_;
+  /** Whether the probe runs in parallel, it does once the whole build side is resident */
+  bool parallel_probe_{false};
+  /** The right batches of the current parallel round, one per thread */
+  std::vector<TupleBatch> probe_batches_;
+  /** The join results of the current parallel round, per thread */
+  std::vector<std::vector<TupleBatch>> probe_outputs_;
+  /** Join results gathered from parallel rounds, not yet handed out */
+  std::deque<TupleBatch> gathered_batches_;
+  /** The position in the selection of the front gathered batch to be returned next by Next() */
+  uint32_t gathered_sel_idx_{0};
+  /** The filter over the build keys pushed into the right child, nullptr if the build side is spilled */
+  std::unique_ptr<RuntimeFilter> runtime_filter_;
+};
+
+}  // namespace bustub
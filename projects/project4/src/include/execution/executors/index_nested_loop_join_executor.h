@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_nested_loop_join_executor.h
+//
+// Identification: src/include/execution/executors/index_nested_loop_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/compiled_predicate.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/hash_join_key.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * IndexNestedLoopJoinExecutor executes an equi-join by probing a hash index of the right table for every left tuple.
+ *
+ * It runs the same plan as HashJoinExecutor when the right plan is a sequential scan whose join key is a column with
+ * a hash index, see FindInnerIndex(). The right table is never scanned: the left tuples are pulled a batch at a
+ * time, the index is probed once for every distinct key of the batch and the matching tuples are fetched by RID,
+ * locked like the scan would lock them, and filtered and projected by the scan plan.
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new IndexNestedLoopJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The equi-join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param index_info The index probed for the right side of join, as found by FindInnerIndex()
+   */
+  IndexNestedLoopJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                              std::unique_ptr<AbstractExecutor> &&left_child, IndexInfo *index_info);
+
+  /**
+   * Find an index that can replace the right child of a join. The right plan has to be a sequential scan, the right
+   * join key one of its output columns that copies a table column, and the index a hash index on that single column,
+   * of the type of the left join key.
+   * @param exec_ctx The executor context
+   * @param plan The equi-join plan
+   * @return The index, nullptr if the right side has to be scanned
+   */
+  static IndexInfo *FindInnerIndex(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch filled with the next join results
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Move forward to the next right tuple matching left_tuple_, pulling left batches on demand.
+   * @return The matching right tuple, nullptr if the left side is exhausted
+   */
+  const Tuple *NextMatch();
+
+  /**
+   * Find the right tuples of a key, probing the index unless the key was already probed for the same left batch.
+   * @param key_value The value of the left join key, not NULL
+   * @return The right tuples with the key, as produced by the right scan plan
+   */
+  const std::vector<Tuple> &Probe(const Value &key_value);
+
+  /**
+   * Evaluate the output columns for a match.
+   * @param right_tuple The right tuple matching left_tuple_
+   * @param[out] values The output values
+   */
+  void EvaluateOutputValues(const Tuple &right_tuple, std::vector<Value> *values);
+
+  /** The equi-join plan node to be executed */
+  const HashJoinPlanNode *plan_;
+  /** The sequential scan the index probes stand in for */
+  const SeqScanPlanNode *scan_plan_;
+  /** The child executor that produces tuple for the left side of join */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The index of the right table on the join column */
+  IndexInfo *index_info_;
+  /** The right table */
+  TableInfo *table_info_;
+  /** The predicate of the right scan plan, lowered against the schema of the right table */
+  CompiledPredicate scan_predicate_;
+  /** The left batch being joined */
+  TupleBatch left_batch_;
+  /** The position in the selection of the left batch of the row to be joined next */
+  uint32_t left_sel_idx_{0};
+  /** Whether the left child has no more tuples */
+  bool left_exhausted_{false};
+  /** The left row being joined, as a tuple */
+  Tuple left_tuple_;
+  /** The right tuples matching left_tuple_, nullptr if there are none */
+  const std::vector<Tuple> *matches_{nullptr};
+  /** The position in matches_ of the right tuple to be joined next */
+  size_t match_idx_{0};
+  /** The right tuples of every key probed for the left batch */
+  std::unordered_map<HashJoinKey, std::vector<Tuple>> probe_cache_;
+  /** Scratch space for the key being probed */
+  HashJoinKey probe_key_;
+  /** Scratch space for the output values */
+  std::vector<Value> output_values_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// nested_loop_join_executor.h
+//
+// Identification: src/include/execution/executors/nested_loop_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/compiled_predicate.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ *
+ * The join is a block nested-loop join: it buffers a block of left tuples that fits into the memory budget of
+ * the executor context and scans the right side once per block, rather than once per left tuple. The join
+ * results are produced on demand, one right tuple against the whole block at a time.
+ *
+ * If the left side does not fit into the first block, the right tuples are cached during the first scan. When
+ * the whole right side fits into half of the budget, the later blocks are joined against the cache and the
+ * right child is never scanned again.
+ */
+class NestedLoopJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new NestedLoopJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The NestedLoop join plan to be executed
+   * @param left_executor The child executor that produces tuple for the left side of join
+   * @param right_executor The child executor that produces tuple for the right side of join
+   */
+  NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
+                         std::unique_ptr<AbstractExecutor> &&left_executor,
+                         std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch filled with the next join results
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the insert */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Move forward to the next pair of a left tuple of the block and the current right tuple that satisfies the
+   * join predicate, pulling right tuples and left blocks on demand.
+   * @return The matching left tuple, the right one is inner_tuple_, nullptr if the join is done
+   */
+  const Tuple *NextMatch();
+
+  /**
+   * Move to the next right tuple of the scan of the current block.
+   * @return `false` if the right side is exhausted for this block
+   */
+  bool NextInnerTuple();
+
+  /**
+   * Buffer the next block of left tuples and rewind the right side.
+   * @return `false` if the left side is exhausted
+   */
+  bool LoadOuterBlock();
+
+  /**
+   * Evaluate the output columns for a match.
+   * @param left_tuple The left tuple
+   * @param[out] values The output values
+   */
+  void EvaluateOutputValues(const Tuple &left_tuple, std::vector<Value> *values);
+
+  /** @return The estimated number of bytes a tuple takes in memory */
+  static size_t TupleMemoryUsage(const Tuple &tuple) { return sizeof(Tuple) + tuple.GetLength(); }
+
+  /** The NestedLoopJoin plan node to be executed. */
+  const NestedLoopJoinPlanNode *plan_;
+  /** The child executor that produces tuple for the left side of join */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  /** The child executor that produces tuple for the right side of join */
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The join predicate, lowered against the output schemas of the children */
+  CompiledPredicate predicate_;
+  /** The memory budget of the executor, in bytes */
+  size_t memory_budget_{0};
+  /** The number of bytes the next block of left tuples may take */
+  size_t block_budget_{0};
+  /** The block of left tuples being joined */
+  std::vector<Tuple> outer_block_;
+  /** The position in the block of the left tuple to be joined next with the current right tuple */
+  size_t outer_idx_{0};
+  /** Whether the left child has no more tuples */
+  bool left_exhausted_{false};
+  /** The right tuple being joined with the block, nullptr if a new one has to be pulled */
+  const Tuple *inner_tuple_{nullptr};
+  /** The right tuple last pulled from the right child */
+  Tuple inner_scan_tuple_;
+  /** The cached right tuples */
+  std::vector<Tuple> inner_cache_;
+  /** The number of bytes taken by the cached right tuples */
+  size_t inner_cache_bytes_{0};
+  /** The position in the cache of the right tuple to be joined next */
+  size_t inner_cache_idx_{0};
+  /** Whether the right tuples are being cached by the current scan of the right child */
+  bool filling_inner_cache_{false};
+  /** Whether the cache holds the whole right side, which is then never scanned again */
+  bool inner_cached_{false};
+  /** Scratch space for the output values */
+  std::vector<Value> output_values_;
+};
+
+}  // namespace bustub
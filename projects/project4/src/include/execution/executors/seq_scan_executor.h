@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.h
+//
+// Identification: src/include/execution/executors/seq_scan_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/compiled_predicate.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/hash_join_key.h"
+#include "execution/morsel_cursor.h"
+#include "execution/runtime_filter.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The predicate of the plan is written against the table schema. It is evaluated on the stored tuple, together with
+ * the runtime filter, before the row is locked or any output column is evaluated, so rows that do not qualify cost
+ * no more than the predicate itself.
+ *
+ * A scan built on a MorselCursor is one worker of a parallel scan: it only scans the morsels it takes from the cursor.
+ */
+class SeqScanExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SeqScanExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   */
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
+
+  /**
+   * Construct a new SeqScanExecutor instance that scans the morsels it takes from a cursor shared with other scans of
+   * the same plan, as one worker of a parallel scan.
+   * @param exec_ctx The executor context
+   * @param plan The sequential scan plan to be executed
+   * @param cursor The cursor handing out the pages of the table, it must outlive the executor
+   */
+  SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, MorselCursor *cursor);
+
+  /** Initialize the sequential scan */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the sequential scan.
+   * @param[out] tuple The next tuple produced by the scan
+   * @param[out] rid The next tuple RID produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The batch filled with the next scanned tuples, only those satisfying the predicate are selected
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /**
+   * Apply a join runtime filter while scanning. The keys are read straight from the table tuples, so rows the
+   * filter rules out are neither locked nor projected.
+   * @param filter The filter, nullptr to remove the current one
+   * @return `true` if the filter is applied, `false` if some key expression is not a plain output column
+   */
+  bool SetRuntimeFilter(const RuntimeFilter *filter) override;
+
+  /** @return The output schema for the sequential scan */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** @return `false` if the runtime filter rules out a table tuple */
+  bool PassesRuntimeFilter(const Tuple &table_tuple);
+
+  /** @return `true` if a table tuple satisfies the predicate and passes the runtime filter */
+  bool Qualifies(const Tuple &table_tuple);
+
+  /** @return `true` if table_itr_ is on a row to be scanned, after moving it to the next morsel if needed */
+  bool HasRow();
+
+  /** @return `true` if table_itr_ was moved to the first row of the next non-empty morsel of the cursor */
+  bool NextMorsel();
+
+  /** The sequential scan plan node to be executed */
+  const SeqScanPlanNode *plan_;
+  /** metadata about a table */
+  TableInfo *table_info_;
+  /** An iterator for the table */
+  TableIterator table_itr_;
+  /** The predicate of the plan, lowered against the table schema */
+  CompiledPredicate predicate_;
+  /** The cursor handing out morsels, nullptr if the executor scans the whole table */
+  MorselCursor *cursor_{nullptr};
+  /** The pages of the morsel being scanned */
+  std::vector<page_id_t> morsel_page_ids_;
+  /** The page of the morsel table_itr_ was last seen on */
+  page_id_t morsel_page_id_{INVALID_PAGE_ID};
+  /** The runtime filter pushed down by a parent join, nullptr if there is none */
+  const RuntimeFilter *runtime_filter_{nullptr};
+  /** The expressions of the runtime filter keys, written against the table schema */
+  std::vector<const AbstractExpression *> filter_key_exprs_;
+  /** Scratch space for the runtime filter key of a tuple */
+  HashJoinKey filter_key_;
+  /** Scratch space for the output values of a row */
+  std::vector<Value> output_values_;
+};
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_merge_join_executor.h
+//
+// Identification: src/include/execution/executors/sort_merge_join_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/sort_key.h"
+#include "execution/tmp_tuple_run.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * SortMergeJoinExecutor executes an equi-join on two inputs sorted on their join keys.
+ *
+ * It runs the same plan as HashJoinExecutor. Both children must produce their tuples in ascending order of their
+ * join key expression, as an ExternalSortExecutor with that single ASC key does; an input that is already sorted
+ * is used as is. The inputs are scanned once, side by side: the right tuples sharing a key are buffered as a group
+ * and every left tuple with that key is joined with the whole group. A group that outgrows the memory budget of
+ * the executor context is continued in temporary pages. Tuples with a NULL key never match.
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SortMergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The equi-join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join, sorted on its join key
+   * @param right_child The child executor that produces tuples for the right side of join, sorted on its join key
+   */
+  SortMergeJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left_child,
+                        std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The batch filled with the next join results
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the join */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Move forward to the next right tuple of the group matching left_tuple_, pulling tuples from both sides on demand.
+   * @return The matching right tuple, nullptr if the join is done
+   */
+  const Tuple *NextMatch();
+
+  /** Pull the next left tuple whose key is not NULL into left_tuple_ */
+  void AdvanceLeft();
+
+  /** Pull the next right tuple whose key is not NULL into right_tuple_ */
+  void AdvanceRight();
+
+  /** Buffer all right tuples with the key of right_tuple_ as the current group */
+  void LoadGroup();
+
+  /** Start joining the next left tuple with the group from its first tuple */
+  void RewindGroup();
+
+  /**
+   * Evaluate the output columns for a match.
+   * @param right_tuple The right tuple matching left_tuple_
+   * @param[out] values The output values
+   */
+  void EvaluateOutputValues(const Tuple &right_tuple, std::vector<Value> *values);
+
+  /**
+   * Build the join key of a tuple, in the order the children are sorted.
+   * @param key_expr The key expression
+   * @param tuple The tuple
+   * @param schema The schema of the tuple
+   * @param[out] sort_key The key
+   */
+  static void MakeKey(const AbstractExpression *key_expr, const Tuple &tuple, const Schema *schema,
+                      SortKey *sort_key) {
+    sort_key->Clear();
+    sort_key->Append(key_expr->Evaluate(&tuple, schema), OrderByType::ASC);
+  }
+
+  /** The equi-join plan node to be executed */
+  const HashJoinPlanNode *plan_;
+  /** The child executor that produces tuple for the left side of join */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The child executor that produces tuple for the right side of join */
+  std::unique_ptr<AbstractExecutor> right_child_;
+  /** The memory budget of the executor, in bytes */
+  size_t memory_budget_{0};
+  /** The left tuple being joined and its key, left_valid_ is `false` once the left child is exhausted */
+  Tuple left_tuple_;
+  SortKey left_key_;
+  bool left_valid_{false};
+  /** The next right tuple not in the group and its key, right_valid_ is `false` once the right child is exhausted */
+  Tuple right_tuple_;
+  SortKey right_key_;
+  bool right_valid_{false};
+  /** Whether left_tuple_ is being joined with the group */
+  bool in_group_{false};
+  /** The key of the group */
+  SortKey group_key_;
+  /** The first right tuples of the group, those fitting into the memory budget */
+  std::vector<Tuple> group_;
+  /** The number of bytes taken by group_ */
+  size_t group_bytes_{0};
+  /** The rest of the group, nullptr if it fit into memory */
+  std::unique_ptr<TmpTupleRun> group_run_;
+  /** The position in group_ of the right tuple to be joined next */
+  size_t group_idx_{0};
+  /** The right tuple last read from group_run_ */
+  Tuple group_run_tuple_;
+  /** Scratch space for the output values */
+  std::vector<Value> output_values_;
+};
+
+}  // namespace bustub
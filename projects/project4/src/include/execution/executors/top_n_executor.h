@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// top_n_executor.h
+//
+// Identification: src/include/execution/executors/top_n_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/sort_key.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TopNExecutor produces the first tuples of its child in the order of a list of ORDER BY expressions, up to the
+ * limit of a limit plan.
+ *
+ * It stands for a limit over a sort, see CreateLimit(). The child tuples are pulled a batch at a time and only the
+ * best `limit` of them are kept, in a max-heap whose top is the worst of them: a row is materialized only if its
+ * key beats the top. This takes O(limit) memory and O(M log limit) time for M child tuples, instead of sorting the
+ * whole child. Like the sort, it is stable.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new TopNExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The limit plan to be executed
+   * @param child_executor The child executor whose tuples are sorted
+   * @param order_bys The ORDER BY expressions with their directions, evaluated on the output schema of the child
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys);
+
+  /**
+   * Create the executor of a limit plan. A limit directly over an ExternalSortExecutor is fused with it into a
+   * TopNExecutor, any other child gets a LimitExecutor.
+   * @param exec_ctx The executor context
+   * @param plan The limit plan to be executed
+   * @param child_executor The executor of the child plan of the limit
+   * @return The executor of the limit
+   */
+  static std::unique_ptr<AbstractExecutor> CreateLimit(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
+                                                       std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the top-N, it consumes the whole child */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the top-N.
+   * @param[out] tuple The next tuple produced by the top-N
+   * @param[out] rid The next tuple RID produced by the top-N
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of tuples from the top-N.
+   * @param[out] batch The batch filled with the next tuples
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the top-N */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+ private:
+  /** A child tuple kept in the heap, with its sort key and its position in the child output */
+  struct TopNEntry {
+    SortKey key_;
+    size_t seq_;
+    Tuple tuple_;
+  };
+
+  /** @return `true` if entry `a` comes before entry `b`, equal keys keep the order of the child */
+  static bool EntryLess(const TopNEntry &a, const TopNEntry &b) {
+    int cmp = a.key_.Compare(b.key_);
+    return cmp < 0 || (cmp == 0 && a.seq_ < b.seq_);
+  }
+
+  /**
+   * Offer a row of a child batch to the heap.
+   * @param batch The child batch
+   * @param row_idx The row
+   */
+  void Offer(const TupleBatch &batch, uint32_t row_idx);
+
+  /** The limit plan node to be executed */
+  const LimitPlanNode *plan_;
+  /** The child executor whose tuples are sorted */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The ORDER BY expressions with their directions */
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  /** The best tuples so far as a max-heap, and in order once the child is exhausted */
+  std::vector<TopNEntry> entries_;
+  /** The position of the next entry to hand out */
+  size_t entry_idx_{0};
+  /** The number of child tuples seen */
+  size_t num_seen_{0};
+  /** Scratch space for the key of the row being offered */
+  SortKey key_;
+};
+
+}  // namespace bustub
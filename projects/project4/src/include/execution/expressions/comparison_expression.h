@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// comparison_expression.h
+//
+// Identification: src/include/expression/comparison_expression.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** ComparisonType represents the type of comparison that we want to perform. */
+enum class ComparisonType { Equal, NotEqual, LessThan, LessThanOrEqual, GreaterThan, GreaterThanOrEqual };
+
+/**
+ * ComparisonExpression represents two expressions being compared.
+ */
+class ComparisonExpression : public AbstractExpression {
+ public:
+  /** Creates a new comparison expression representing (left comp_type right). */
+  ComparisonExpression(const AbstractExpression *left, const AbstractExpression *right, ComparisonType comp_type)
+      : AbstractExpression({left, right}, TypeId::BOOLEAN), comp_type_{comp_type} {}
+
+  Value Evaluate(const Tuple *tuple, const Schema *schema) const override {
+    Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
+    Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
+                     const Schema *right_schema) const override {
+    Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const override {
+    Value lhs = GetChildAt(0)->EvaluateAggregate(group_bys, aggregates);
+    Value rhs = GetChildAt(1)->EvaluateAggregate(group_bys, aggregates);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  /** @return The type of comparison performed */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
+  /**
+   * Compare two already evaluated operands, for callers that produce the operands themselves.
+   * @param lhs The left operand
+   * @param rhs The right operand
+   * @return The result of (lhs comp_type rhs)
+   */
+  CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
+    switch (comp_type_) {
+      case ComparisonType::Equal:
+        return lhs.CompareEquals(rhs);
+      case ComparisonType::NotEqual:
+        return lhs.CompareNotEquals(rhs);
+      case ComparisonType::LessThan:
+        return lhs.CompareLessThan(rhs);
+      case ComparisonType::LessThanOrEqual:
+        return lhs.CompareLessThanEquals(rhs);
+      case ComparisonType::GreaterThan:
+        return lhs.CompareGreaterThan(rhs);
+      case ComparisonType::GreaterThanOrEqual:
+        return lhs.CompareGreaterThanEquals(rhs);
+      default:
+        BUSTUB_ASSERT(false, "Unsupported comparison type.");
+    }
+  }
+
+ private:
+  std::vector<const AbstractExpression *> children_;
+  ComparisonType comp_type_;
+};
+}  // namespace bustub
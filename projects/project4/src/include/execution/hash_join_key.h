@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_key.h
+//
+// Identification: src/include/execution/hash_join_key.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * HashJoinKey represents a key in a hash join operation, made of one value per join key expression.
+ *
+ * The values are kept serialized in a normalized form, so that keys that compare equal have the same bytes:
+ * integers of any width are widened to 64 bits and -0.0 is folded into 0.0. A key is hashed as it is built
+ * and compared with memcmp.
+ */
+class HashJoinKey {
+ public:
+  /** Empty the key, so it can be built again */
+  void Clear() {
+    data_.clear();
+    hash_ = 0;
+    has_null_ = false;
+  }
+
+  /**
+   * Append the value of the next join key expression.
+   * @param value the value to append
+   */
+  void Append(const Value &value) {
+    if (value.IsNull()) {
+      has_null_ = true;
+      return;
+    }
+    size_t offset = data_.size();
+    switch (value.GetTypeId()) {
+      case TypeId::VARCHAR: {
+        // The length goes first, so the values of a composite key cannot run into each other
+        uint32_t length = value.GetLength();
+        data_.resize(offset + sizeof(uint32_t) + length);
+        memcpy(data_.data() + offset, &length, sizeof(uint32_t));
+        memcpy(data_.data() + offset + sizeof(uint32_t), value.GetData(), length);
+        break;
+      }
+      case TypeId::DECIMAL: {
+        double raw = value.GetAs<double>();
+        // -0.0 == 0.0, so both are stored as 0.0
+        if (raw == 0) {
+          raw = 0;
+        }
+        data_.resize(offset + sizeof(double));
+        memcpy(data_.data() + offset, &raw, sizeof(double));
+        break;
+      }
+      default: {
+        int64_t raw = WidenInteger(value);
+        data_.resize(offset + sizeof(int64_t));
+        memcpy(data_.data() + offset, &raw, sizeof(int64_t));
+        break;
+      }
+    }
+    hash_ = HashUtil::CombineHashes(hash_, HashUtil::HashBytes(data_.data() + offset, data_.size() - offset));
+  }
+
+  /**
+   * Make this key a copy of a key stored by a HashJoinTable.
+   * @param data the serialized values
+   * @param size the number of bytes of the serialized values
+   * @param hash the hash of the key
+   */
+  void Assign(const char *data, uint32_t size, hash_t hash) {
+    data_.assign(data, data + size);
+    hash_ = hash;
+    has_null_ = false;
+  }
+
+  /** @return `true` if some value of the key is NULL, such a key never matches another key */
+  bool HasNull() const { return has_null_; }
+
+  /** @return the serialized values */
+  const char *GetData() const { return data_.data(); }
+
+  /** @return the number of bytes of the serialized values */
+  uint32_t GetSize() const { return static_cast<uint32_t>(data_.size()); }
+
+  /** @return the hash of the key */
+  hash_t GetHash() const { return hash_; }
+
+  /**
+   * Compare two hash join keys for equality
+   * @param other the other hash join key to be compared with
+   * @return `true` if both hash join keys have equal values
+   */
+  bool operator==(const HashJoinKey &other) const { return hash_ == other.hash_ && data_ == other.data_; }
+
+ private:
+  /**
+   * Read an integer value of any width. Value::GetAs reads the raw storage of the value, so a narrow integer
+   * has to be read with its own type.
+   * @param value the value, of an integer, boolean or timestamp type
+   * @return the value widened to 64 bits
+   */
+  static int64_t WidenInteger(const Value &value) {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return value.GetAs<int8_t>();
+      case TypeId::SMALLINT:
+        return value.GetAs<int16_t>();
+      case TypeId::INTEGER:
+        return value.GetAs<int32_t>();
+      default:
+        return value.GetAs<int64_t>();
+    }
+  }
+
+  /** The serialized values */
+  std::vector<char> data_;
+  /** The hash of the serialized values */
+  hash_t hash_{0};
+  /** Whether some value is NULL, NULL values are not serialized */
+  bool has_null_{false};
+};
+
+}  // namespace bustub
+
+namespace std {
+
+/** Implements std::hash on HashJoinKey */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &hash_key) const { return hash_key.GetHash(); }
+};
+
+}  // namespace std
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_cursor.h
+//
+// Identification: src/include/execution/morsel_cursor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * MorselCursor hands out the pages of a table heap, a few consecutive pages (a morsel) at a time, to the
+ * sequential scans of a parallel scan. Every page goes to exactly one scan, and a scan that is done with its
+ * morsel asks for the next one, so faster workers simply scan more morsels.
+ */
+class MorselCursor {
+ public:
+  /** The number of pages in a morsel */
+  static constexpr size_t MORSEL_SIZE = 4;
+
+  /**
+   * Create a cursor positioned on the first page of a table.
+   * @param table the table heap whose pages are handed out
+   * @param bpm the buffer pool manager the pages are read from, to follow the page chain
+   */
+  MorselCursor(TableHeap *table, BufferPoolManager *bpm) : table_(table), bpm_(bpm) { Reset(); }
+
+  DISALLOW_COPY_AND_MOVE(MorselCursor);
+
+  /** Move back to the first page of the table, so the table can be scanned again. */
+  void Reset() {
+    std::scoped_lock latch(latch_);
+    next_page_id_ = table_->GetFirstPageId();
+  }
+
+  /**
+   * Take the next morsel. Safe to call from several threads at once.
+   * @param[out] page_ids the pages of the morsel, in the order of the page chain
+   * @return false if all pages have been handed out
+   */
+  bool NextMorsel(std::vector<page_id_t> *page_ids);
+
+ private:
+  /** The table heap whose pages are handed out */
+  TableHeap *table_;
+  /** The buffer pool manager the pages are read from */
+  BufferPoolManager *bpm_;
+  /** Protects next_page_id_ */
+  std::mutex latch_;
+  /** The first page not handed out yet, INVALID_PAGE_ID at the end of the table */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+};
+
+}  // namespace bustub
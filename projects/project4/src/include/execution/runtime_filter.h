@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/hash_join_key.h"
+
+namespace bustub {
+
+/**
+ * RuntimeFilter is a Bloom filter over the join keys of one side of a join. The join builds it once it has
+ * seen every key of that side and pushes it into the executor producing the other side, which drops the rows
+ * whose key is certainly not in the filter before doing any more work on them.
+ *
+ * The filter is blocked: all bits of a key live in the same 64-bit word, so a lookup touches one cache line.
+ */
+class RuntimeFilter {
+ public:
+  /** The number of filter bits per key, for a false positive rate of a few percent */
+  static constexpr size_t BITS_PER_KEY = 10;
+  /** The number of bits set by a key */
+  static constexpr uint32_t NUM_BITS_PER_KEY = 3;
+
+  /**
+   * Create an empty filter.
+   * @param key_exprs the expressions of the key columns, written against the output schema of the executor
+   * that applies the filter
+   * @param num_keys the number of distinct keys that will be inserted
+   */
+  RuntimeFilter(std::vector<const AbstractExpression *> key_exprs, size_t num_keys)
+      : key_exprs_{std::move(key_exprs)} {
+    size_t num_words = 1;
+    while (num_words * 64 < num_keys * BITS_PER_KEY) {
+      num_words *= 2;
+    }
+    words_.assign(num_words, 0);
+  }
+
+  /** @return the expressions of the key columns */
+  const std::vector<const AbstractExpression *> &GetKeyExpressions() const { return key_exprs_; }
+
+  /**
+   * Add a key to the filter.
+   * @param key_hash the hash of the key, as returned by HashJoinKey::GetHash()
+   */
+  void Insert(hash_t key_hash) {
+    uint64_t hash = Mix(key_hash);
+    words_[hash & (words_.size() - 1)] |= KeyBits(hash);
+  }
+
+  /**
+   * Test a key against the filter.
+   * @param hash_key the key
+   * @return `false` if the key was certainly not inserted, `true` if it may have been
+   */
+  bool MayContain(const HashJoinKey &hash_key) const {
+    if (hash_key.HasNull()) {
+      return false;
+    }
+    uint64_t hash = Mix(hash_key.GetHash());
+    uint64_t key_bits = KeyBits(hash);
+    return (words_[hash & (words_.size() - 1)] & key_bits) == key_bits;
+  }
+
+ private:
+  /** Spread the bits of a key hash, the word and the bits in it are taken from different parts of the result */
+  static uint64_t Mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /** @return the bits of a key in its word, picked with the top bits of the mixed hash */
+  static uint64_t KeyBits(uint64_t hash) {
+    uint64_t key_bits = 0;
+    for (uint32_t i = 0; i < NUM_BITS_PER_KEY; i++) {
+      key_bits |= uint64_t{1} << ((hash >> (64 - 6 * (i + 1))) & 63);
+    }
+    return key_bits;
+  }
+
+  /** The expressions of the key columns */
+  std::vector<const AbstractExpression *> key_exprs_;
+  /** The filter bits, the number of words is a power of two */
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace bustub
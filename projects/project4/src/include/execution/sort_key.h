@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "type/value.h"
+
+namespace bustub {
+
+/** The direction of an ORDER BY key */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * SortKey is the normalized form of a sort key, made of one value per ORDER BY expression.
+ *
+ * Each value is encoded so that comparing two keys with memcmp orders them like their values: integers are
+ * widened to 64 bits and stored big-endian with the sign bit flipped, decimals get the usual float bit twiddling
+ * and varchars are terminated by two zero bytes, after escaping their own zero bytes. A NULL sorts before any
+ * other value. The bytes of a descending value are inverted.
+ */
+class SortKey {
+ public:
+  /** Empty the key, so it can be built again */
+  void Clear() {
+    data_.clear();
+    has_null_ = false;
+  }
+
+  /**
+   * Append the value of the next ORDER BY expression.
+   * @param value the value to append
+   * @param order_by_type the direction of the expression
+   */
+  void Append(const Value &value, OrderByType order_by_type) {
+    size_t offset = data_.size();
+    if (value.IsNull()) {
+      has_null_ = true;
+      data_.push_back(0);
+    } else {
+      data_.push_back(1);
+      switch (value.GetTypeId()) {
+        case TypeId::VARCHAR: {
+          const char *bytes = value.GetData();
+          for (uint32_t i = 0; i < value.GetLength(); i++) {
+            data_.push_back(bytes[i]);
+            if (bytes[i] == 0) {
+              data_.push_back(static_cast<char>(0xff));
+            }
+          }
+          data_.push_back(0);
+          data_.push_back(0);
+          break;
+        }
+        case TypeId::DECIMAL: {
+          double raw = value.GetAs<double>();
+          // -0.0 == 0.0, so both are stored as 0.0
+          if (raw == 0) {
+            raw = 0;
+          }
+          uint64_t bits;
+          memcpy(&bits, &raw, sizeof(double));
+          AppendBigEndian((bits & SIGN_BIT) != 0 ? ~bits : bits | SIGN_BIT);
+          break;
+        }
+        case TypeId::TIMESTAMP:
+          AppendBigEndian(value.GetAs<uint64_t>());
+          break;
+        default:
+          AppendBigEndian(static_cast<uint64_t>(WidenInteger(value)) ^ SIGN_BIT);
+          break;
+      }
+    }
+    if (order_by_type == OrderByType::DESC) {
+      for (size_t i = offset; i < data_.size(); i++) {
+        data_[i] = static_cast<char>(~data_[i]);
+      }
+    }
+  }
+
+  /** @return `true` if some value of the key is NULL */
+  bool HasNull() const { return has_null_; }
+
+  /** @return the normalized values, two keys are equal if and only if their bytes are */
+  const char *GetData() const { return data_.data(); }
+
+  /** @return the number of bytes of the normalized values */
+  uint32_t GetSize() const { return static_cast<uint32_t>(data_.size()); }
+
+  /**
+   * Compare two sort keys built from the same ORDER BY expressions.
+   * @param other the other sort key
+   * @return a negative number, zero or a positive number if this key sorts before, with or after the other key
+   */
+  int Compare(const SortKey &other) const {
+    int cmp = memcmp(data_.data(), other.data_.data(), std::min(data_.size(), other.data_.size()));
+    if (cmp != 0) {
+      return cmp;
+    }
+    return data_.size() < other.data_.size() ? -1 : (data_.size() > other.data_.size() ? 1 : 0);
+  }
+
+  /** @return `true` if this key sorts before the other key */
+  bool operator<(const SortKey &other) const { return Compare(other) < 0; }
+
+  /** @return `true` if both keys have equal values */
+  bool operator==(const SortKey &other) const { return data_ == other.data_; }
+
+ private:
+  static constexpr uint64_t SIGN_BIT = uint64_t{1} << 63;
+
+  /** Append 8 bytes, the most significant one first */
+  void AppendBigEndian(uint64_t bits) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      data_.push_back(static_cast<char>((bits >> shift) & 0xff));
+    }
+  }
+
+  /** @return an integer or boolean value read with its own width, then widened to 64 bits */
+  static int64_t WidenInteger(const Value &value) {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return value.GetAs<int8_t>();
+      case TypeId::SMALLINT:
+        return value.GetAs<int16_t>();
+      case TypeId::INTEGER:
+        return value.GetAs<int32_t>();
+      default:
+        return value.GetAs<int64_t>();
+    }
+  }
+
+  /** The normalized values */
+  std::vector<char> data_;
+  /** Whether some value is NULL */
+  bool has_null_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_run.h
+//
+// Identification: src/include/execution/tmp_tuple_run.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "common/util/hash_util.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleRun is an append-only sequence of tuples spilled to TmpTuplePages, for executors that
+ * have to move data out of memory. Tuples are read back in the order they were appended.
+ *
+ * Only the page being written and the page being read are pinned. All pages are deleted from the
+ * buffer pool when the run is destroyed.
+ */
+class TmpTupleRun {
+ public:
+  /**
+   * Create an empty run.
+   * @param bpm the buffer pool manager the temporary pages are allocated from
+   */
+  explicit TmpTupleRun(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleRun();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleRun);
+
+  /**
+   * Append a tuple to the end of the run.
+   * @param tuple the tuple to append, it has to fit into a single page
+   */
+  void Append(const Tuple &tuple);
+
+  /** Unpin the last written page. Call it once all tuples are appended. */
+  void FinishWrite();
+
+  /** Start reading the run from its first tuple. */
+  void BeginRead();
+
+  /**
+   * Read the next tuple of the run.
+   * @param[out] tuple the tuple read
+   * @return false if all tuples have been read
+   */
+  bool Next(Tuple *tuple);
+
+  /** @return the number of tuples in the run */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+  /** @return the number of bytes of tuple data in the run */
+  size_t GetNumBytes() const { return num_bytes_; }
+
+ private:
+  /** Pin the page at read_page_idx_ and collect the offsets of its tuples in append order */
+  void LoadReadPage();
+
+  /** Unpin the page being read, if any */
+  void ReleaseReadPage();
+
+  BufferPoolManager *bpm_;
+  /** The pages of the run, in append order */
+  std::vector<page_id_t> page_ids_;
+  /** The page being written, pinned, nullptr if there is none */
+  TmpTuplePage *write_page_{nullptr};
+  size_t num_tuples_{0};
+  size_t num_bytes_{0};
+
+  /** The page being read, pinned, nullptr if there is none */
+  TmpTuplePage *read_page_{nullptr};
+  size_t read_page_idx_{0};
+  /** Offsets of the tuples of the page being read, the next one is at the back */
+  std::vector<uint32_t> read_offsets_;
+};
+
+/**
+ * Pick the partition a key is spilled to. Every level has to split the partitions of the level above it, so the
+ * level is mixed into the hash non-linearly: HashUtil::CombineHashes is linear in XOR, with it the partitions of a
+ * level would only be a permutation of those of the level above.
+ * @param hash the hash of the key
+ * @param level the number of times the key has been partitioned before
+ * @param num_partitions the number of partitions of a level
+ * @return the partition of the key, less than num_partitions
+ */
+inline size_t SpillPartitionOf(hash_t hash, uint32_t level, size_t num_partitions) {
+  // The finalizer of MurmurHash3, over the hash offset by a multiple of the level
+  uint64_t mixed = static_cast<uint64_t>(hash) + (level + uint64_t{1}) * 0x9E3779B97F4A7C15ULL;
+  mixed = (mixed ^ (mixed >> 33)) * 0xFF51AFD7ED558CCDULL;
+  mixed = (mixed ^ (mixed >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  return (mixed ^ (mixed >> 33)) % num_partitions;
+}
+
+}  // namespace bustub
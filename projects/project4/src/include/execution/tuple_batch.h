@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch is a fixed-capacity batch of rows that executors pass to each other through NextBatch().
+ *
+ * Rows are stored column-major: one vector of values per column of the schema, so operators that
+ * only touch a few columns never build a Tuple. A selection vector lists the rows that are still
+ * alive; Truncate() shrinks it instead of moving data, and consumers only look at selected rows.
+ */
+class TupleBatch {
+ public:
+  /** The maximum number of rows in a batch */
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+  TupleBatch() = default;
+
+  /**
+   * Empty the batch and lay it out for a new schema.
+   * @param schema The schema of the rows in the batch, may be `nullptr` for executors without output
+   */
+  void Reset(const Schema *schema);
+
+  /** @return The schema of the rows in the batch */
+  const Schema *GetSchema() const { return schema_; }
+
+  /** @return The number of rows stored in the batch, selected or not */
+  uint32_t NumRows() const { return static_cast<uint32_t>(rids_.size()); }
+
+  /** @return The number of selected rows */
+  uint32_t Size() const { return static_cast<uint32_t>(selection_.size()); }
+
+  /** @return `true` if no row is selected */
+  bool IsEmpty() const { return selection_.empty(); }
+
+  /** @return `true` if no more rows fit into the batch */
+  bool IsFull() const { return NumRows() >= capacity_; }
+
+  /** @return The number of rows producers may append, at most BATCH_SIZE */
+  uint32_t GetCapacity() const { return capacity_; }
+
+  /**
+   * Limit the number of rows producers may append. The capacity survives Reset(), so a consumer that needs
+   * fewer rows than a full batch can keep its child from producing the rest.
+   * @param capacity The number of rows, at most BATCH_SIZE
+   */
+  void SetCapacity(uint32_t capacity) { capacity_ = std::min(capacity, BATCH_SIZE); }
+
+  /**
+   * Append a row given as one value per column. The row is selected.
+   * @param values The values of the row, in schema order
+   * @param rid The RID of the row
+   */
+  void AppendValues(const std::vector<Value> &values, const RID &rid);
+
+  /**
+   * Append a row given as a tuple of the batch schema. The row is selected.
+   * @param tuple The tuple to decode into the batch
+   * @param rid The RID of the row
+   */
+  void AppendTuple(const Tuple &tuple, const RID &rid);
+
+  /** @return The value of a column in a stored row */
+  const Value &GetValue(uint32_t row_idx, uint32_t col_idx) const { return columns_[col_idx][row_idx]; }
+
+  /** @return All values of a column, indexed by row */
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return The RID of a stored row */
+  const RID &GetRid(uint32_t row_idx) const { return rids_[row_idx]; }
+
+  /** @return The indexes of the selected rows, in order */
+  const std::vector<uint32_t> &GetSelection() const { return selection_; }
+
+  /**
+   * Keep only the first `size` selected rows.
+   * @param size The number of selected rows to keep
+   */
+  void Truncate(uint32_t size);
+
+  /**
+   * Evaluate an expression on a stored row, as expr->Evaluate() would on the row's tuple.
+   *
+   * Column references, constants and comparisons over them read the columns directly, any other
+   * expression falls back to evaluating it on the materialized tuple.
+   * @param expr The expression, written against the batch schema
+   * @param row_idx The row to evaluate the expression on
+   * @return The value of the expression
+   */
+  Value EvaluateAt(const AbstractExpression *expr, uint32_t row_idx) const;
+
+  /**
+   * Build the tuple of a stored row.
+   * @param row_idx The row to materialize
+   * @return The row as a tuple of the batch schema
+   */
+  Tuple MaterializeRow(uint32_t row_idx) const;
+
+ private:
+  /** The schema of the rows */
+  const Schema *schema_{nullptr};
+  /** The number of rows producers may append */
+  uint32_t capacity_{BATCH_SIZE};
+  /** One vector of values per column */
+  std::vector<std::vector<Value>> columns_;
+  /** One RID per row */
+  std::vector<RID> rids_;
+  /** The selected rows */
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
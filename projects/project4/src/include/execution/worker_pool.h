@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_pool.h
+//
+// Identification: src/include/execution/worker_pool.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * WorkerPool keeps threads alive for the lifetime of an executor, so that its parallel phases do not start
+ * and join threads every time. Run() hands out the tasks of a phase one at a time: the calling thread and the
+ * pool threads each take the next task not taken yet until all are done, then the pool threads wait for the
+ * next phase.
+ */
+class WorkerPool {
+ public:
+  /**
+   * Start the threads of the pool.
+   * @param num_threads the number of threads running the tasks, including the thread calling Run()
+   */
+  explicit WorkerPool(size_t num_threads);
+
+  DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  /** Stop and join the threads of the pool */
+  ~WorkerPool();
+
+  /** @return the number of threads running the tasks, including the thread calling Run() */
+  size_t GetNumThreads() const { return threads_.size() + 1; }
+
+  /**
+   * Run task(0), ..., task(num_tasks - 1) concurrently and wait for all of them. Not to be called from a task.
+   * @param num_tasks the number of tasks
+   * @param task the task, called with the index of the task
+   * @throws the first exception thrown by a task, once all tasks are done
+   */
+  void Run(size_t num_tasks, const std::function<void(size_t)> &task);
+
+ private:
+  /** The loop of a pool thread, it runs the tasks of every phase until the pool is stopped */
+  void RunWorker();
+
+  /**
+   * Take and run tasks of the current phase until none is left to take.
+   * @param latch the held latch_, it is released while a task runs
+   */
+  void RunTasks(std::unique_lock<std::mutex> *latch);
+
+  /** The pool threads */
+  std::vector<std::thread> threads_;
+  /** Protects everything below */
+  std::mutex latch_;
+  /** Signaled when a phase starts or the pool is stopped */
+  std::condition_variable has_tasks_;
+  /** Signaled when the last task of a phase is done */
+  std::condition_variable tasks_done_;
+  /** The task of the current phase, nullptr between phases */
+  const std::function<void(size_t)> *task_{nullptr};
+  /** The number of tasks of the current phase */
+  size_t num_tasks_{0};
+  /** The next task to be taken */
+  size_t next_task_{0};
+  /** The number of tasks of the current phase that are not done yet */
+  size_t num_unfinished_{0};
+  /** The first exception thrown by a task of the current phase */
+  std::exception_ptr error_;
+  /** Whether the pool threads have to exit */
+  bool stopping_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "storage/page/page.h"
+#include "storage/table/tmp_tuple.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
+// existing functions exactly as they are! It may be helpful to look at TablePage.
+// Remember that this task is optional, you get full credit if you finish the next task.
+
+/**
+ * TmpTuplePage format:
+ *
+ * Sizes are in bytes.
+ * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
+ *
+ * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ * Every TupleSize starts at a multiple of 4 bytes, the padding follows TupleData.
+ */
+class TmpTuplePage : public Page {
+ public:
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Insert a tuple at the end of the free space.
+   * @param tuple the tuple to insert
+   * @param[out] out the location of the inserted tuple
+   * @return false if the page does not have enough free space for the tuple
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t tuple_size = AlignSize(sizeof(uint32_t) + tuple.GetLength());
+    if (GetFreeSpaceRemaining() < tuple_size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - tuple_size;
+    // Tuple::SerializeTo writes the size followed by the data, which is the format of a slot
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
+
+  /**
+   * Read the tuple stored at an offset.
+   * @param offset the offset of the tuple, as returned by Insert or by iterating from GetFreeSpacePointer()
+   * @param[out] tuple the tuple read
+   */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
+
+  /**
+   * @return the offset of the tuple stored at offset, plus its padded size, i.e. the offset of the tuple inserted
+   * before
+   */
+  uint32_t GetNextOffset(size_t offset) {
+    uint32_t size;
+    memcpy(&size, GetData() + offset, sizeof(uint32_t));
+    return static_cast<uint32_t>(offset + AlignSize(sizeof(uint32_t) + size));
+  }
+
+  /** @return the offset of the start of free space, which is also the offset of the last inserted tuple */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /** @return the number of bytes left for tuples and their sizes */
+  uint32_t GetFreeSpaceRemaining() { return GetFreeSpacePointer() - SIZE_TMP_PAGE_HEADER; }
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+
+  /** @return the size rounded up to a multiple of 4, so the next slot is aligned for its TupleSize */
+  static uint32_t AlignSize(size_t size) { return static_cast<uint32_t>((size + 3) & ~size_t{3}); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+};
+
+}  // namespace bustub
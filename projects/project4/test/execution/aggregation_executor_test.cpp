@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor_test.cpp
+//
+// Identification: test/execution/aggregation_executor_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/aggregation_executor.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Hands out a fixed list of tuples, the child of the aggregations under test */
+class TupleListExecutor : public AbstractExecutor {
+ public:
+  TupleListExecutor(ExecutorContext *exec_ctx, const Schema *schema, const std::vector<Tuple> *tuples)
+      : AbstractExecutor(exec_ctx), schema_(schema), tuples_(tuples) {}
+
+  void Init() override { next_idx_ = 0; }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    if (next_idx_ == tuples_->size()) {
+      return false;
+    }
+    *tuple = (*tuples_)[next_idx_++];
+    *rid = tuple->GetRid();
+    return true;
+  }
+
+  const Schema *GetOutputSchema() override { return schema_; }
+
+ private:
+  const Schema *schema_;
+  const std::vector<Tuple> *tuples_;
+  size_t next_idx_{0};
+};
+
+class AggregationExecutorTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>("aggregation_executor_test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(32, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("aggregation_executor_test.db");
+    remove("aggregation_executor_test.log");
+    ::testing::Test::TearDown();
+  };
+
+  /**
+   * Compute SELECT key, COUNT(val), SUM(val), MIN(val), MAX(val) GROUP BY key over (key, val) rows.
+   * @param rows the input rows
+   * @param memory_budget the number of bytes the aggregation may keep in memory
+   * @param degree_of_parallelism the number of threads the aggregation may use
+   * @return the output rows as strings, sorted
+   */
+  std::vector<std::string> Aggregate(const std::vector<std::pair<int32_t, int32_t>> &rows, size_t memory_budget,
+                                     size_t degree_of_parallelism) {
+    ColumnValueExpression key_expr(0, 0, TypeId::INTEGER);
+    ColumnValueExpression val_expr(0, 1, TypeId::INTEGER);
+    Schema child_schema({Column("key", TypeId::INTEGER, &key_expr), Column("val", TypeId::INTEGER, &val_expr)});
+    std::vector<Tuple> tuples;
+    for (const auto &[key, val] : rows) {
+      tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(key), ValueFactory::GetIntegerValue(val)},
+                          &child_schema);
+    }
+
+    AggregateValueExpression group_key(true, 0, TypeId::INTEGER);
+    AggregateValueExpression count(false, 0, TypeId::INTEGER);
+    AggregateValueExpression sum(false, 1, TypeId::INTEGER);
+    AggregateValueExpression min(false, 2, TypeId::INTEGER);
+    AggregateValueExpression max(false, 3, TypeId::INTEGER);
+    Schema output_schema({Column("key", TypeId::INTEGER, &group_key), Column("count", TypeId::INTEGER, &count),
+                          Column("sum", TypeId::INTEGER, &sum), Column("min", TypeId::INTEGER, &min),
+                          Column("max", TypeId::INTEGER, &max)});
+    AggregationPlanNode plan(&output_schema, nullptr, nullptr, {&key_expr},
+                             {&val_expr, &val_expr, &val_expr, &val_expr},
+                             {AggregationType::CountAggregate, AggregationType::SumAggregate,
+                              AggregationType::MinAggregate, AggregationType::MaxAggregate});
+
+    ExecutorContext exec_ctx(nullptr, nullptr, bpm_.get(), nullptr, nullptr);
+    exec_ctx.SetMemoryBudget(memory_budget);
+    exec_ctx.SetDegreeOfParallelism(degree_of_parallelism);
+    AggregationExecutor aggregation(&exec_ctx, &plan,
+                                    std::make_unique<TupleListExecutor>(&exec_ctx, &child_schema, &tuples));
+    aggregation.Init();
+    std::vector<std::string> result;
+    Tuple tuple;
+    RID rid;
+    while (aggregation.Next(&tuple, &rid)) {
+      result.push_back(tuple.ToString(&output_schema));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+ private:
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, SpilledGroupsMatchInMemory) {
+  // 1001 groups, a quarter of the rows fall into the group 0
+  std::vector<std::pair<int32_t, int32_t>> rows;
+  for (int32_t i = 0; i < 6000; i++) {
+    rows.emplace_back(i % 4 == 0 ? 0 : i % 1001, i % 17 - 8);
+  }
+  auto expected = Aggregate(rows, ExecutorContext::DEFAULT_MEMORY_BUDGET, 1);
+  ASSERT_EQ(1001, expected.size());
+  // A budget of a single byte keeps one group per level, the rest is partitioned down to the last level
+  for (size_t memory_budget : {size_t{1}, size_t{2048}, size_t{32768}}) {
+    for (size_t degree_of_parallelism : {1, 4}) {
+      EXPECT_EQ(expected, Aggregate(rows, memory_budget, degree_of_parallelism));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationExecutorTest, SingleGroupOverBudget) {
+  // Most rows are in the group 7, whichever level of partitioning it ends up aggregated at
+  std::vector<std::pair<int32_t, int32_t>> rows;
+  for (int32_t i = 0; i < 3000; i++) {
+    rows.emplace_back(i % 100 == 0 ? i : 7, i);
+  }
+  auto expected = Aggregate(rows, ExecutorContext::DEFAULT_MEMORY_BUDGET, 1);
+  ASSERT_EQ(31, expected.size());
+  for (size_t degree_of_parallelism : {1, 4}) {
+    EXPECT_EQ(expected, Aggregate(rows, 1, degree_of_parallelism));
+  }
+}
+
+}  // namespace bustub
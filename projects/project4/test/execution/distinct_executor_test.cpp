@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// distinct_executor_test.cpp
+//
+// Identification: test/execution/distinct_executor_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/distinct_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/distinct_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Hands out a fixed list of tuples, the child of the distincts under test */
+class TupleListExecutor : public AbstractExecutor {
+ public:
+  TupleListExecutor(ExecutorContext *exec_ctx, const Schema *schema, const std::vector<Tuple> *tuples)
+      : AbstractExecutor(exec_ctx), schema_(schema), tuples_(tuples) {}
+
+  void Init() override { next_idx_ = 0; }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    if (next_idx_ == tuples_->size()) {
+      return false;
+    }
+    *tuple = (*tuples_)[next_idx_++];
+    *rid = tuple->GetRid();
+    return true;
+  }
+
+  const Schema *GetOutputSchema() override { return schema_; }
+
+ private:
+  const Schema *schema_;
+  const std::vector<Tuple> *tuples_;
+  size_t next_idx_{0};
+};
+
+/** A row of the input: a nullable integer and a varchar */
+using DistinctRow = std::tuple<bool, int32_t, std::string>;
+
+class DistinctExecutorTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>("distinct_executor_test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(32, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("distinct_executor_test.db");
+    remove("distinct_executor_test.log");
+    ::testing::Test::TearDown();
+  };
+
+  /**
+   * Remove the duplicate rows.
+   * @param rows the input rows, the integer is NULL if the first member is true
+   * @param memory_budget the number of bytes the distinct may keep in memory
+   * @return the output rows as strings, sorted
+   */
+  std::vector<std::string> Distinct(const std::vector<DistinctRow> &rows, size_t memory_budget) {
+    Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+    std::vector<Tuple> tuples;
+    for (const auto &[a_is_null, a, b] : rows) {
+      Value a_value =
+          a_is_null ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(a);
+      tuples.emplace_back(std::vector<Value>{a_value, ValueFactory::GetVarcharValue(b)}, &schema);
+    }
+    DistinctPlanNode plan(&schema, nullptr);
+    ExecutorContext exec_ctx(nullptr, nullptr, bpm_.get(), nullptr, nullptr);
+    exec_ctx.SetMemoryBudget(memory_budget);
+    DistinctExecutor distinct(&exec_ctx, &plan, std::make_unique<TupleListExecutor>(&exec_ctx, &schema, &tuples));
+    distinct.Init();
+    std::vector<std::string> result;
+    Tuple tuple;
+    RID rid;
+    while (distinct.Next(&tuple, &rid)) {
+      result.push_back(tuple.ToString(&schema));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+ private:
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(DistinctExecutorTest, SpilledRowsMatchInMemory) {
+  // About 700 distinct rows, NULLs included, a third of the input is a single row
+  std::vector<DistinctRow> rows;
+  for (int32_t i = 0; i < 5000; i++) {
+    if (i % 3 == 0) {
+      rows.emplace_back(false, 0, "hot");
+    } else {
+      rows.emplace_back(i % 29 == 0, i % 101, "b" + std::to_string(i % 7));
+    }
+  }
+  std::set<DistinctRow> distinct_rows;
+  for (const auto &[a_is_null, a, b] : rows) {
+    distinct_rows.emplace(a_is_null, a_is_null ? 0 : a, b);
+  }
+  auto expected = Distinct(rows, ExecutorContext::DEFAULT_MEMORY_BUDGET);
+  ASSERT_EQ(distinct_rows.size(), expected.size());
+  ASSERT_TRUE(std::adjacent_find(expected.begin(), expected.end()) == expected.end());
+  // Under a budget of a single byte nothing fits, every row is partitioned down to MAX_PARTITION_LEVEL
+  for (size_t memory_budget : {size_t{1}, size_t{1024}, size_t{8192}}) {
+    EXPECT_EQ(expected, Distinct(rows, memory_budget));
+  }
+}
+
+}  // namespace bustub
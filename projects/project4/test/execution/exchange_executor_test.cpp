@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor_test.cpp
+//
+// Identification: test/execution/exchange_executor_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "common/exception.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executors/exchange_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** A worker that produces single row batches until it is stopped, or throws after a number of batches */
+class EndlessExecutor : public AbstractExecutor {
+ public:
+  /**
+   * @param exec_ctx the executor context
+   * @param schema the output schema, of a single INTEGER column
+   * @param num_batches the number of batches produced before throwing, 0 to never throw
+   * @param num_produced counts the batches produced by all workers
+   */
+  EndlessExecutor(ExecutorContext *exec_ctx, const Schema *schema, size_t num_batches,
+                  std::atomic<size_t> *num_produced)
+      : AbstractExecutor(exec_ctx), schema_(schema), num_batches_(num_batches), num_produced_(num_produced) {}
+
+  void Init() override { num_batches_done_ = 0; }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    TupleBatch batch;
+    NextBatch(&batch);
+    *tuple = batch.MaterializeRow(0);
+    *rid = batch.GetRid(0);
+    return true;
+  }
+
+  bool NextBatch(TupleBatch *batch) override {
+    if (num_batches_ != 0 && num_batches_done_ == num_batches_) {
+      throw Exception(ExceptionType::INVALID, "EndlessExecutor: out of batches.");
+    }
+    batch->Reset(schema_);
+    batch->AppendValues({ValueFactory::GetIntegerValue(static_cast<int32_t>(num_batches_done_++))}, RID{});
+    num_produced_->fetch_add(1);
+    return true;
+  }
+
+  const Schema *GetOutputSchema() override { return schema_; }
+
+ private:
+  const Schema *schema_;
+  size_t num_batches_;
+  size_t num_batches_done_{0};
+  std::atomic<size_t> *num_produced_;
+};
+
+class ExchangeExecutorTest : public ::testing::Test {
+ public:
+  static constexpr int32_t NUM_ROWS = 20000;
+
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>("exchange_executor_test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(256, disk_manager_.get());
+    lock_manager_ = std::make_unique<LockManager>();
+    txn_mgr_ = std::make_unique<TransactionManager>(lock_manager_.get());
+    catalog_ = std::make_unique<Catalog>(bpm_.get(), lock_manager_.get(), nullptr);
+
+    // A table of row numbers, spread over enough pages to keep several workers busy
+    auto *txn = txn_mgr_->Begin();
+    Schema schema({Column("row", TypeId::INTEGER), Column("payload", TypeId::INTEGER)});
+    table_info_ = catalog_->CreateTable(txn, "rows", schema);
+    for (int32_t row = 0; row < NUM_ROWS; row++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(row), ValueFactory::GetIntegerValue(row * 7)}, &table_info_->schema_);
+      RID rid;
+      EXPECT_TRUE(table_info_->table_->InsertTuple(tuple, &rid, txn));
+    }
+    txn_mgr_->Commit(txn);
+    delete txn;
+  }
+
+  void TearDown() override {
+    for (auto &txn : txns_) {
+      txn_mgr_->Commit(txn.get());
+    }
+    txns_.clear();
+    catalog_.reset();
+    txn_mgr_.reset();
+    lock_manager_.reset();
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("exchange_executor_test.db");
+    remove("exchange_executor_test.log");
+    ::testing::Test::TearDown();
+  };
+
+  /** @return a context to run the executors of a test in, with a transaction of its own */
+  std::unique_ptr<ExecutorContext> MakeContext(size_t degree_of_parallelism) {
+    txns_.emplace_back(txn_mgr_->Begin());
+    auto exec_ctx = std::make_unique<ExecutorContext>(txns_.back().get(), catalog_.get(), bpm_.get(), txn_mgr_.get(),
+                                                      lock_manager_.get());
+    exec_ctx->SetDegreeOfParallelism(degree_of_parallelism);
+    return exec_ctx;
+  }
+
+  /** @return the row numbers produced by the executor, sorted */
+  static std::vector<int32_t> DrainRows(AbstractExecutor *executor) {
+    std::vector<int32_t> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.push_back(tuple.GetValue(executor->GetOutputSchema(), 0).GetAs<int32_t>());
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  }
+
+  /** @return 0, 1, ..., NUM_ROWS - 1 */
+  static std::vector<int32_t> AllRows() {
+    std::vector<int32_t> rows(NUM_ROWS);
+    std::iota(rows.begin(), rows.end(), 0);
+    return rows;
+  }
+
+  ColumnValueExpression row_expr_{0, 0, TypeId::INTEGER};
+  Schema scan_schema_{{Column("row", TypeId::INTEGER, &row_expr_)}};
+  const TableInfo *table_info_{nullptr};
+
+ private:
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<TransactionManager> txn_mgr_;
+  std::unique_ptr<Catalog> catalog_;
+  std::vector<std::unique_ptr<Transaction>> txns_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(ExchangeExecutorTest, ParallelScanProducesEveryRowOnce) {
+  SeqScanPlanNode plan(&scan_schema_, nullptr, table_info_->oid_);
+  for (size_t degree_of_parallelism : {2, 4, 8}) {
+    auto exec_ctx = MakeContext(degree_of_parallelism);
+    auto scan = ExchangeExecutor::CreateParallelScan(exec_ctx.get(), &plan);
+    scan->Init();
+    EXPECT_EQ(AllRows(), DrainRows(scan.get()));
+
+    // A batch consumer sees the same rows
+    scan->Init();
+    std::vector<int32_t> rows;
+    TupleBatch batch;
+    while (scan->NextBatch(&batch)) {
+      for (uint32_t row_idx : batch.GetSelection()) {
+        rows.push_back(batch.GetValue(row_idx, 0).GetAs<int32_t>());
+      }
+    }
+    std::sort(rows.begin(), rows.end());
+    EXPECT_EQ(AllRows(), rows);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExchangeExecutorTest, InitWhileWorkersRun) {
+  SeqScanPlanNode plan(&scan_schema_, nullptr, table_info_->oid_);
+  auto exec_ctx = MakeContext(4);
+  auto scan = ExchangeExecutor::CreateParallelScan(exec_ctx.get(), &plan);
+  for (int run = 0; run < 3; run++) {
+    // Start the workers and leave them with most of the table to scan
+    scan->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(scan->Next(&tuple, &rid));
+  }
+  // The restarted scan begins from the first page again
+  scan->Init();
+  EXPECT_EQ(AllRows(), DrainRows(scan.get()));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExchangeExecutorTest, WorkerExceptionReachesParent) {
+  auto exec_ctx = MakeContext(1);
+  std::atomic<size_t> num_produced{0};
+  std::vector<std::unique_ptr<AbstractExecutor>> workers;
+  // One worker fails early, the others would run forever
+  workers.emplace_back(std::make_unique<EndlessExecutor>(exec_ctx.get(), &scan_schema_, 3, &num_produced));
+  for (int i = 0; i < 3; i++) {
+    workers.emplace_back(std::make_unique<EndlessExecutor>(exec_ctx.get(), &scan_schema_, 0, &num_produced));
+  }
+  ExchangeExecutor exchange(exec_ctx.get(), std::move(workers), nullptr);
+  exchange.Init();
+  TupleBatch batch;
+  EXPECT_THROW(
+      {
+        while (exchange.NextBatch(&batch)) {
+        }
+      },
+      Exception);
+
+  // After Init() the exchange runs again, and fails again
+  exchange.Init();
+  EXPECT_THROW(
+      {
+        while (exchange.NextBatch(&batch)) {
+        }
+      },
+      Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExchangeExecutorTest, DestroyWhileWorkersBlockOnFullQueue) {
+  auto exec_ctx = MakeContext(1);
+  constexpr size_t num_workers = 4;
+  std::atomic<size_t> num_produced{0};
+  std::vector<std::unique_ptr<AbstractExecutor>> workers;
+  for (size_t i = 0; i < num_workers; i++) {
+    workers.emplace_back(std::make_unique<EndlessExecutor>(exec_ctx.get(), &scan_schema_, 0, &num_produced));
+  }
+  auto exchange = std::make_unique<ExchangeExecutor>(exec_ctx.get(), std::move(workers), nullptr);
+  exchange->Init();
+  TupleBatch batch;
+  ASSERT_TRUE(exchange->NextBatch(&batch));
+  // Once the queue is full again and every worker holds a batch it cannot queue, all of them are blocked
+  size_t num_blocked = ExchangeExecutor::QUEUED_BATCHES_PER_WORKER * num_workers + 1 + num_workers;
+  while (num_produced.load() < num_blocked) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(num_blocked, num_produced.load());
+  // The destructor wakes and joins the blocked workers
+  exchange.reset();
+  EXPECT_EQ(num_blocked, num_produced.load());
+}
+
+}  // namespace bustub
@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_executor_test.cpp
+//
+// Identification: test/execution/external_sort_executor_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/external_sort_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Hands out a fixed list of tuples, the child of the sorts under test */
+class TupleListExecutor : public AbstractExecutor {
+ public:
+  TupleListExecutor(ExecutorContext *exec_ctx, const Schema *schema, const std::vector<Tuple> *tuples)
+      : AbstractExecutor(exec_ctx), schema_(schema), tuples_(tuples) {}
+
+  void Init() override { next_idx_ = 0; }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    if (next_idx_ == tuples_->size()) {
+      return false;
+    }
+    *tuple = (*tuples_)[next_idx_++];
+    *rid = tuple->GetRid();
+    return true;
+  }
+
+  const Schema *GetOutputSchema() override { return schema_; }
+
+ private:
+  const Schema *schema_;
+  const std::vector<Tuple> *tuples_;
+  size_t next_idx_{0};
+};
+
+/** A row of the input: a nullable integer, a varchar and the position of the row in the input */
+struct SortRow {
+  bool key_is_null_;
+  int32_t key_;
+  std::string name_;
+  int32_t seq_;
+};
+
+class ExternalSortExecutorTest : public ::testing::Test {
+ public:
+  // The pool is small, so the merge fan-in is bound by the pool and temporary pages are evicted to disk
+  static constexpr size_t POOL_SIZE = 10;
+
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>("external_sort_executor_test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(POOL_SIZE, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("external_sort_executor_test.db");
+    remove("external_sort_executor_test.log");
+    ::testing::Test::TearDown();
+  };
+
+  /**
+   * Sort the rows.
+   * @param rows the input rows
+   * @param order_by_types the directions of the key column and the name column, the name is only sorted on if
+   * there are two of them
+   * @param memory_budget the number of bytes the sort may keep in memory
+   * @return the seq column of the sorted rows
+   */
+  std::vector<int32_t> Sort(const std::vector<SortRow> &rows, const std::vector<OrderByType> &order_by_types,
+                            size_t memory_budget) {
+    std::vector<Tuple> tuples;
+    for (const auto &row : rows) {
+      Value key = row.key_is_null_ ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                   : ValueFactory::GetIntegerValue(row.key_);
+      tuples.emplace_back(std::vector<Value>{key, ValueFactory::GetVarcharValue(row.name_),
+                                             ValueFactory::GetIntegerValue(row.seq_)},
+                          &schema_);
+    }
+    ExecutorContext exec_ctx(nullptr, nullptr, bpm_.get(), nullptr, nullptr);
+    exec_ctx.SetMemoryBudget(memory_budget);
+    std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys;
+    for (size_t i = 0; i < order_by_types.size(); i++) {
+      order_bys.emplace_back(order_by_types[i], i == 0 ? &key_expr_ : &name_expr_);
+    }
+    auto sort = std::make_unique<ExternalSortExecutor>(
+        &exec_ctx, std::make_unique<TupleListExecutor>(&exec_ctx, &schema_, &tuples), std::move(order_bys));
+    sort->Init();
+
+    std::vector<int32_t> seqs;
+    Tuple tuple;
+    RID rid;
+    while (sort->Next(&tuple, &rid)) {
+      // The name has to come back with its embedded zero bytes
+      int32_t seq = tuple.GetValue(&schema_, 2).GetAs<int32_t>();
+      EXPECT_EQ(rows[seq].name_, tuple.GetValue(&schema_, 1).ToString());
+      seqs.push_back(seq);
+    }
+    // The runs give all their pages back
+    sort.reset();
+    EXPECT_EQ(0, CountPinnedFrames());
+    return seqs;
+  }
+
+  /** @return the seq column of the rows stably sorted on the key column, a NULL key sorts as the smallest one */
+  static std::vector<int32_t> ExpectedSort(std::vector<SortRow> rows, OrderByType key_order,
+                                           bool sort_on_name = false) {
+    auto key_less = [](const SortRow &a, const SortRow &b) {
+      if (a.key_is_null_ || b.key_is_null_) {
+        return a.key_is_null_ && !b.key_is_null_;
+      }
+      return a.key_ < b.key_;
+    };
+    std::stable_sort(rows.begin(), rows.end(), [&](const SortRow &a, const SortRow &b) {
+      if (key_order == OrderByType::ASC ? key_less(a, b) : key_less(b, a)) {
+        return true;
+      }
+      if (key_order == OrderByType::ASC ? key_less(b, a) : key_less(a, b)) {
+        return false;
+      }
+      return sort_on_name && a.name_ < b.name_;
+    });
+    std::vector<int32_t> seqs;
+    for (const auto &row : rows) {
+      seqs.push_back(row.seq_);
+    }
+    return seqs;
+  }
+
+ private:
+  /** @return the number of frames still pinned, by fetching as many new pages as the pool holds */
+  size_t CountPinnedFrames() {
+    std::vector<page_id_t> page_ids;
+    page_id_t page_id;
+    while (page_ids.size() < POOL_SIZE && bpm_->NewPage(&page_id) != nullptr) {
+      page_ids.push_back(page_id);
+    }
+    for (page_id_t new_page_id : page_ids) {
+      bpm_->UnpinPage(new_page_id, false);
+      bpm_->DeletePage(new_page_id);
+    }
+    return POOL_SIZE - page_ids.size();
+  }
+
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  ColumnValueExpression key_expr_{0, 0, TypeId::INTEGER};
+  ColumnValueExpression name_expr_{0, 1, TypeId::VARCHAR};
+  Schema schema_{{Column("key", TypeId::INTEGER, &key_expr_), Column("name", TypeId::VARCHAR, 16, &name_expr_),
+                  Column("seq", TypeId::INTEGER)}};
+};
+
+/** Rows with many duplicate keys, every tenth one NULL */
+static std::vector<SortRow> DuplicateKeyRows(size_t num_rows) {
+  std::mt19937 rng(15445);
+  std::vector<SortRow> rows;
+  for (size_t i = 0; i < num_rows; i++) {
+    auto key = static_cast<int32_t>(std::uniform_int_distribution<int32_t>(-50, 50)(rng));
+    rows.push_back(SortRow{i % 10 == 0, key, "row" + std::to_string(i % 7), static_cast<int32_t>(i)});
+  }
+  return rows;
+}
+
+// Memory budgets and the merge they lead to, with the pool of 10 frames
+static const size_t IN_MEMORY_BUDGET = ExecutorContext::DEFAULT_MEMORY_BUDGET;
+// A run per tuple, merged two at a time
+static const size_t SINGLE_TUPLE_BUDGET = 1;
+// Runs of about a hundred tuples, merged three at a time, the last group of a pass may hold a single run
+static const size_t FAN_IN_3_BUDGET = 3 * PAGE_SIZE + 100;
+// Runs of about two hundred tuples, merged five at a time, the groups of a pass differ in size
+static const size_t FAN_IN_5_BUDGET = 5 * PAGE_SIZE + 100;
+
+// NOLINTNEXTLINE
+TEST_F(ExternalSortExecutorTest, AscendingAndDescendingWithNulls) {
+  auto rows = DuplicateKeyRows(1500);
+  for (auto order_by_type : {OrderByType::ASC, OrderByType::DESC}) {
+    auto expected = ExpectedSort(rows, order_by_type);
+    // NULLs come first ascending and last descending
+    ASSERT_EQ(order_by_type == OrderByType::ASC, rows[expected.front()].key_is_null_);
+    ASSERT_EQ(order_by_type == OrderByType::DESC, rows[expected.back()].key_is_null_);
+    for (size_t memory_budget : {IN_MEMORY_BUDGET, FAN_IN_3_BUDGET, FAN_IN_5_BUDGET}) {
+      EXPECT_EQ(expected, Sort(rows, {order_by_type}, memory_budget));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExternalSortExecutorTest, TiesKeepInputOrder) {
+  // Few distinct keys, so most tuples tie with tuples of other runs and the merge decides their order
+  std::vector<SortRow> rows;
+  for (int32_t i = 0; i < 2000; i++) {
+    rows.push_back(SortRow{false, (i * 7) % 3, "", i});
+  }
+  for (auto order_by_type : {OrderByType::ASC, OrderByType::DESC}) {
+    auto expected = ExpectedSort(rows, order_by_type);
+    for (size_t memory_budget : {IN_MEMORY_BUDGET, SINGLE_TUPLE_BUDGET, FAN_IN_3_BUDGET, FAN_IN_5_BUDGET}) {
+      EXPECT_EQ(expected, Sort(rows, {order_by_type}, memory_budget));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExternalSortExecutorTest, VarcharWithEmbeddedZeroBytes) {
+  const std::vector<std::string> names = {std::string("a\0b", 3), "a", std::string("a\0", 2), std::string("a\0\0", 3),
+                                          "", std::string("\0", 1), "ab", std::string("a\0a", 3), "b"};
+  std::vector<SortRow> rows;
+  for (int32_t i = 0; i < 450; i++) {
+    rows.push_back(SortRow{i % 5 == 0, i % 2, names[i % names.size()], i});
+  }
+  for (auto order_by_type : {OrderByType::ASC, OrderByType::DESC}) {
+    auto expected = ExpectedSort(rows, order_by_type, true);
+    for (size_t memory_budget : {IN_MEMORY_BUDGET, FAN_IN_3_BUDGET, FAN_IN_5_BUDGET}) {
+      EXPECT_EQ(expected, Sort(rows, {order_by_type, OrderByType::ASC}, memory_budget));
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,262 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor_test.cpp
+//
+// Identification: test/execution/hash_join_executor_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/hash_join_key.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+class HashJoinExecutorTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ::testing::Test::SetUp();
+    disk_manager_ = std::make_unique<DiskManager>("hash_join_executor_test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(256, disk_manager_.get());
+    lock_manager_ = std::make_unique<LockManager>();
+    txn_mgr_ = std::make_unique<TransactionManager>(lock_manager_.get());
+    catalog_ = std::make_unique<Catalog>(bpm_.get(), lock_manager_.get(), nullptr);
+    execution_engine_ = std::make_unique<ExecutionEngine>(bpm_.get(), txn_mgr_.get(), catalog_.get());
+  }
+
+  void TearDown() override {
+    execution_engine_.reset();
+    catalog_.reset();
+    txn_mgr_.reset();
+    lock_manager_.reset();
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("hash_join_executor_test.db");
+    remove("hash_join_executor_test.log");
+    ::testing::Test::TearDown();
+  };
+
+  /**
+   * Create a table of a key column and a row number column.
+   * @param name the name of the table
+   * @param key_type the type of the key column
+   * @param keys the keys of the rows, a key is NULL if its first member is false
+   * @return the table
+   */
+  const TableInfo *MakeTable(const std::string &name, TypeId key_type,
+                             const std::vector<std::pair<bool, int64_t>> &keys) {
+    auto *txn = txn_mgr_->Begin();
+    Schema schema({Column("key", key_type), Column("row", TypeId::INTEGER)});
+    TableInfo *table_info = catalog_->CreateTable(txn, name, schema);
+    for (size_t row = 0; row < keys.size(); row++) {
+      Value key = ValueFactory::GetNullValueByType(key_type);
+      if (keys[row].first) {
+        key = key_type == TypeId::INTEGER ? ValueFactory::GetIntegerValue(static_cast<int32_t>(keys[row].second))
+                                          : ValueFactory::GetBigIntValue(keys[row].second);
+      }
+      Tuple tuple({key, ValueFactory::GetIntegerValue(static_cast<int32_t>(row))}, &table_info->schema_);
+      RID rid;
+      EXPECT_TRUE(table_info->table_->InsertTuple(tuple, &rid, txn));
+    }
+    txn_mgr_->Commit(txn);
+    delete txn;
+    return table_info;
+  }
+
+  /**
+   * Join two tables on their key columns.
+   * @param memory_budget the number of bytes the join may keep in memory, the rest is spilled
+   * @return the (left row, right row) pairs of the join, sorted
+   */
+  std::vector<std::pair<int32_t, int32_t>> Join(const TableInfo *left, const TableInfo *right,
+                                                size_t degree_of_parallelism,
+                                                size_t memory_budget = ExecutorContext::DEFAULT_MEMORY_BUDGET) {
+    // Both scans output the key and the row number of their table
+    TypeId left_type = left->schema_.GetColumn(0).GetType();
+    TypeId right_type = right->schema_.GetColumn(0).GetType();
+    ColumnValueExpression left_scan_key(0, 0, left_type);
+    ColumnValueExpression left_scan_row(0, 1, TypeId::INTEGER);
+    ColumnValueExpression right_scan_key(0, 0, right_type);
+    ColumnValueExpression right_scan_row(0, 1, TypeId::INTEGER);
+    Schema left_schema({Column("key", left_type, &left_scan_key), Column("row", TypeId::INTEGER, &left_scan_row)});
+    Schema right_schema({Column("key", right_type, &right_scan_key), Column("row", TypeId::INTEGER, &right_scan_row)});
+    SeqScanPlanNode left_scan(&left_schema, nullptr, left->oid_);
+    SeqScanPlanNode right_scan(&right_schema, nullptr, right->oid_);
+
+    // The join outputs the row numbers of the matching rows
+    ColumnValueExpression left_key(0, 0, left_type);
+    ColumnValueExpression left_row(0, 1, TypeId::INTEGER);
+    ColumnValueExpression right_key(1, 0, right_type);
+    ColumnValueExpression right_row(1, 1, TypeId::INTEGER);
+    Schema output_schema(
+        {Column("left_row", TypeId::INTEGER, &left_row), Column("right_row", TypeId::INTEGER, &right_row)});
+    HashJoinPlanNode join(&output_schema, {&left_scan, &right_scan}, &left_key, &right_key);
+
+    auto *txn = txn_mgr_->Begin();
+    ExecutorContext exec_ctx(txn, catalog_.get(), bpm_.get(), txn_mgr_.get(), lock_manager_.get());
+    exec_ctx.SetDegreeOfParallelism(degree_of_parallelism);
+    exec_ctx.SetMemoryBudget(memory_budget);
+    std::vector<Tuple> result_set;
+    execution_engine_->Execute(&join, &result_set, txn, &exec_ctx);
+    txn_mgr_->Commit(txn);
+    delete txn;
+
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    for (const auto &tuple : result_set) {
+      pairs.emplace_back(tuple.GetValue(&output_schema, 0).GetAs<int32_t>(),
+                         tuple.GetValue(&output_schema, 1).GetAs<int32_t>());
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  }
+
+  /** @return the (left row, right row) pairs whose keys are equal and not NULL, sorted */
+  static std::vector<std::pair<int32_t, int32_t>> ExpectedJoin(
+      const std::vector<std::pair<bool, int64_t>> &left_keys, const std::vector<std::pair<bool, int64_t>> &right_keys) {
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    for (size_t left_row = 0; left_row < left_keys.size(); left_row++) {
+      for (size_t right_row = 0; right_row < right_keys.size(); right_row++) {
+        if (left_keys[left_row].first && right_keys[right_row].first &&
+            left_keys[left_row].second == right_keys[right_row].second) {
+          pairs.emplace_back(left_row, right_row);
+        }
+      }
+    }
+    return pairs;
+  }
+
+ private:
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<TransactionManager> txn_mgr_;
+  std::unique_ptr<Catalog> catalog_;
+  std::unique_ptr<ExecutionEngine> execution_engine_;
+};
+
+/** Keys of 32 bit values, duplicates, NULLs and the extremes of INTEGER included */
+static std::vector<std::pair<bool, int64_t>> IntegerKeys(size_t num_keys) {
+  std::vector<std::pair<bool, int64_t>> keys;
+  for (size_t i = 0; i < num_keys; i++) {
+    keys.emplace_back(i % 11 != 0, static_cast<int64_t>(i % 97) - 48);
+  }
+  keys.emplace_back(true, std::numeric_limits<int32_t>::max());
+  keys.emplace_back(true, std::numeric_limits<int32_t>::min() + 1);
+  return keys;
+}
+
+/** Keys where every third row has the key 0 and the rest are spread over a few hundred values */
+static std::vector<std::pair<bool, int64_t>> SkewedKeys(size_t num_keys) {
+  std::vector<std::pair<bool, int64_t>> keys;
+  for (size_t i = 0; i < num_keys; i++) {
+    keys.emplace_back(i % 13 != 0, i % 3 == 0 ? 0 : static_cast<int64_t>(i % 251));
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(HashJoinKeyTest, IntegerWidths) {
+  HashJoinKey integer_key;
+  HashJoinKey bigint_key;
+  for (int64_t raw : {int64_t{0}, int64_t{-1}, int64_t{7}, int64_t{std::numeric_limits<int32_t>::max()}}) {
+    integer_key.Clear();
+    integer_key.Append(ValueFactory::GetIntegerValue(static_cast<int32_t>(raw)));
+    bigint_key.Clear();
+    bigint_key.Append(ValueFactory::GetBigIntValue(raw));
+    EXPECT_TRUE(integer_key == bigint_key);
+    EXPECT_EQ(integer_key.GetHash(), bigint_key.GetHash());
+  }
+  // The same low 32 bits do not make a BIGINT equal to an INTEGER
+  integer_key.Clear();
+  integer_key.Append(ValueFactory::GetIntegerValue(1));
+  bigint_key.Clear();
+  bigint_key.Append(ValueFactory::GetBigIntValue((int64_t{1} << 32) + 1));
+  EXPECT_FALSE(integer_key == bigint_key);
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, IntegerKeys) {
+  auto left_keys = IntegerKeys(300);
+  auto right_keys = IntegerKeys(500);
+  const TableInfo *left = MakeTable("left", TypeId::INTEGER, left_keys);
+  const TableInfo *right = MakeTable("right", TypeId::INTEGER, right_keys);
+  auto expected = ExpectedJoin(left_keys, right_keys);
+  ASSERT_FALSE(expected.empty());
+  for (size_t degree_of_parallelism : {1, 4}) {
+    EXPECT_EQ(expected, Join(left, right, degree_of_parallelism));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, MixedIntegerAndBigIntKeys) {
+  auto left_keys = IntegerKeys(300);
+  auto right_keys = IntegerKeys(200);
+  // BIGINT keys that only match an INTEGER key in their low 32 bits
+  right_keys.emplace_back(true, (int64_t{1} << 32) + 5);
+  right_keys.emplace_back(true, -(int64_t{1} << 32) - 5);
+  right_keys.emplace_back(true, int64_t{std::numeric_limits<int32_t>::max()} + 1);
+  const TableInfo *left = MakeTable("left", TypeId::INTEGER, left_keys);
+  const TableInfo *right = MakeTable("right", TypeId::BIGINT, right_keys);
+  auto expected = ExpectedJoin(left_keys, right_keys);
+  ASSERT_FALSE(expected.empty());
+  for (size_t degree_of_parallelism : {1, 4}) {
+    EXPECT_EQ(expected, Join(left, right, degree_of_parallelism));
+    EXPECT_EQ(ExpectedJoin(right_keys, left_keys), Join(right, left, degree_of_parallelism));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, SpillsWithSmallBudgets) {
+  auto left_keys = SkewedKeys(2000);
+  auto right_keys = SkewedKeys(700);
+  const TableInfo *left = MakeTable("left", TypeId::INTEGER, left_keys);
+  const TableInfo *right = MakeTable("right", TypeId::INTEGER, right_keys);
+  auto expected = ExpectedJoin(left_keys, right_keys);
+  ASSERT_FALSE(expected.empty());
+  // A budget of a single byte spills every partition and partitions it again down to the last level
+  for (size_t memory_budget : {size_t{1}, size_t{4096}, size_t{30000}}) {
+    for (size_t degree_of_parallelism : {1, 4}) {
+      EXPECT_EQ(expected, Join(left, right, degree_of_parallelism, memory_budget));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(HashJoinExecutorTest, SpilledSingleKeyStopsPartitioning) {
+  // No hash split separates the rows of the key 7, its partition is joined once MAX_PARTITION_LEVEL is reached
+  std::vector<std::pair<bool, int64_t>> left_keys(1500, {true, 7});
+  std::vector<std::pair<bool, int64_t>> right_keys(20, {true, 7});
+  for (int64_t key = 0; key < 100; key++) {
+    left_keys.emplace_back(true, key);
+    right_keys.emplace_back(true, key);
+  }
+  const TableInfo *left = MakeTable("left", TypeId::INTEGER, left_keys);
+  const TableInfo *right = MakeTable("right", TypeId::INTEGER, right_keys);
+  auto expected = ExpectedJoin(left_keys, right_keys);
+  ASSERT_EQ(1501 * 21 + 99, expected.size());
+  for (size_t degree_of_parallelism : {1, 4}) {
+    EXPECT_EQ(expected, Join(left, right, degree_of_parallelism, 4096));
+  }
+}
+
+}  // namespace bustub